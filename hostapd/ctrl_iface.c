@@ -1464,7 +1464,11 @@ static int hostapd_ctrl_iface_set(struct hostapd_data *hapd, char *cmd)
 		if (ret)
 			return ret;
 
-		if (os_strcasecmp(cmd, "deny_mac_file") == 0) {
+		if (os_strncasecmp(cmd, "logger_", 7) == 0) {
+			if (hapd->iface->interfaces)
+				hostapd_logger_update_modules(
+					hapd->iface->interfaces);
+		} else if (os_strcasecmp(cmd, "deny_mac_file") == 0) {
 			hostapd_disassoc_deny_mac(hapd);
 		} else if (os_strcasecmp(cmd, "accept_mac_file") == 0) {
 			hostapd_disassoc_accept_mac(hapd);
@@ -2703,6 +2707,88 @@ static int hostapd_ctrl_iface_mib(struct hostapd_data *hapd, char *reply,
 }
 
 
+#ifdef CONFIG_LATENCY_STATS
+
+static int hostapd_ctrl_iface_latency_hist(const char *name,
+					   struct hostapd_radius_server *serv,
+					   struct latency_hist *hist,
+					   char *buf, size_t buflen)
+{
+	char abuf[50];
+	int ret, len = 0;
+
+	if (serv)
+		ret = os_snprintf(buf, buflen, "%s server=%s:%d ", name,
+				  hostapd_ip_txt(&serv->addr, abuf,
+						 sizeof(abuf)),
+				  serv->port);
+	else
+		ret = os_snprintf(buf, buflen, "%s ", name);
+	if (os_snprintf_error(buflen, ret))
+		return 0;
+	len += ret;
+
+	ret = latency_hist_print(hist, buf + len, buflen - len);
+	if (ret == 0)
+		return 0;
+	return len + ret;
+}
+
+
+static int hostapd_ctrl_iface_latency_stats(struct hostapd_data *hapd,
+					    const char *cmd, char *buf,
+					    size_t buflen)
+{
+	struct hostapd_radius_servers *servers = hapd->conf->radius;
+	int i, reset, len = 0;
+
+	reset = os_strcmp(cmd, " reset") == 0;
+	if (!reset && *cmd)
+		return -1;
+
+	if (reset) {
+		latency_hist_reset(&hapd->eapol_radius_hist);
+		latency_hist_reset(&hapd->eap_step_hist);
+		latency_hist_reset(&hapd->auth_complete_hist);
+	} else {
+		len += hostapd_ctrl_iface_latency_hist(
+			"eapol_to_radius", NULL, &hapd->eapol_radius_hist,
+			buf + len, buflen - len);
+		len += hostapd_ctrl_iface_latency_hist(
+			"eap_step", NULL, &hapd->eap_step_hist,
+			buf + len, buflen - len);
+		len += hostapd_ctrl_iface_latency_hist(
+			"auth_complete", NULL, &hapd->auth_complete_hist,
+			buf + len, buflen - len);
+	}
+
+	for (i = 0; servers && i < servers->num_auth_servers; i++) {
+		if (reset)
+			latency_hist_reset(&servers->auth_servers[i].rtt_hist);
+		else
+			len += hostapd_ctrl_iface_latency_hist(
+				"radius_auth_rtt", &servers->auth_servers[i],
+				&servers->auth_servers[i].rtt_hist,
+				buf + len, buflen - len);
+	}
+	for (i = 0; servers && i < servers->num_acct_servers; i++) {
+		if (reset)
+			latency_hist_reset(&servers->acct_servers[i].rtt_hist);
+		else
+			len += hostapd_ctrl_iface_latency_hist(
+				"radius_acct_rtt", &servers->acct_servers[i],
+				&servers->acct_servers[i].rtt_hist,
+				buf + len, buflen - len);
+	}
+
+	if (reset)
+		return os_snprintf(buf, buflen, "OK\n");
+	return len;
+}
+
+#endif /* CONFIG_LATENCY_STATS */
+
+
 static int hostapd_ctrl_iface_vendor(struct hostapd_data *hapd, char *cmd,
 				     char *buf, size_t buflen)
 {
@@ -3301,11 +3387,11 @@ static int hostapd_ctrl_iface_get_capability(struct hostapd_data *hapd,
 }
 
 
-static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
-					      char *buf, char *reply,
-					      int reply_size,
-					      struct sockaddr_storage *from,
-					      socklen_t fromlen)
+static int hostapd_ctrl_iface_process_cmd(struct hostapd_data *hapd,
+					  char *buf, char *reply,
+					  int reply_size,
+					  struct sockaddr_storage *from,
+					  socklen_t fromlen)
 {
 	int reply_len, res;
 
@@ -3366,6 +3452,24 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 	} else if (os_strncmp(buf, "STA-NEXT ", 9) == 0) {
 		reply_len = hostapd_ctrl_iface_sta_next(hapd, buf + 9, reply,
 							reply_size);
+#ifdef CONFIG_LATENCY_STATS
+	} else if (os_strncmp(buf, "LATENCY_STATS", 13) == 0) {
+		reply_len = hostapd_ctrl_iface_latency_stats(hapd, buf + 13,
+							     reply, reply_size);
+#endif /* CONFIG_LATENCY_STATS */
+	} else if (os_strcmp(buf, "CTRL_STATS") == 0) {
+		reply_len = ctrl_iface_cmd_stats_print(
+			hapd->iface->interfaces ?
+			hapd->iface->interfaces->ctrl_stats : NULL,
+			reply, reply_size);
+	} else if (os_strcmp(buf, "CTRL_STATS reset") == 0) {
+		if (hapd->iface->interfaces)
+			ctrl_iface_cmd_stats_flush(
+				hapd->iface->interfaces->ctrl_stats);
+	} else if (os_strcmp(buf, "STA-DUMP") == 0 ||
+		   os_strncmp(buf, "STA-DUMP ", 9) == 0) {
+		reply_len = hostapd_ctrl_iface_sta_dump(hapd, buf + 8, reply,
+							reply_size);
 	} else if (os_strcmp(buf, "ATTACH") == 0) {
 		if (hostapd_ctrl_iface_attach(hapd, from, fromlen, NULL))
 			reply_len = -1;
@@ -3617,6 +3721,8 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 	} else if (os_strcmp(buf, "TERMINATE") == 0) {
 		eloop_terminate();
 	} else if (os_strncmp(buf, "ACCEPT_ACL ", 11) == 0) {
+		if (os_strcmp(buf + 11, "SHOW") != 0)
+			hostapd_config_mark_modified(hapd->conf);
 		if (os_strncmp(buf + 11, "ADD_MAC ", 8) == 0) {
 			if (!hostapd_ctrl_iface_acl_add_mac(
 				    &hapd->conf->accept_mac,
@@ -3638,6 +3744,8 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 				&hapd->conf->num_accept_mac);
 		}
 	} else if (os_strncmp(buf, "DENY_ACL ", 9) == 0) {
+		if (os_strcmp(buf + 9, "SHOW") != 0)
+			hostapd_config_mark_modified(hapd->conf);
 		if (os_strncmp(buf + 9, "ADD_MAC ", 8) == 0) {
 			if (!hostapd_ctrl_iface_acl_add_mac(
 				    &hapd->conf->deny_mac,
@@ -3808,6 +3916,32 @@ static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
 }
 
 
+static int hostapd_ctrl_iface_receive_process(struct hostapd_data *hapd,
+					      char *buf, char *reply,
+					      int reply_size,
+					      struct sockaddr_storage *from,
+					      socklen_t fromlen)
+{
+	struct hapd_interfaces *interfaces = hapd->iface->interfaces;
+	char name[CTRL_IFACE_CMD_NAME_LEN];
+	struct os_reltime start;
+	int reply_len;
+
+	if (!interfaces || !interfaces->ctrl_stats)
+		return hostapd_ctrl_iface_process_cmd(hapd, buf, reply,
+						      reply_size, from,
+						      fromlen);
+
+	ctrl_iface_cmd_name(buf, name, sizeof(name));
+	os_get_reltime(&start);
+	reply_len = hostapd_ctrl_iface_process_cmd(hapd, buf, reply, reply_size,
+						   from, fromlen);
+	ctrl_iface_cmd_stats_add(interfaces->ctrl_stats, name, &start);
+
+	return reply_len;
+}
+
+
 static void hostapd_ctrl_iface_receive(int sock, void *eloop_ctx,
 				       void *sock_ctx)
 {
@@ -10,9 +10,254 @@
 
 #include "utils/common.h"
 #include "utils/module_tests.h"
+#include "ap/ap_config.h"
+#include "config_file.h"
+
+
+static int config_read_bench_write(FILE *f, unsigned int num_bss)
+{
+	unsigned int i;
+
+	fprintf(f, "interface=bench0\nhw_mode=g\nchannel=1\n");
+	for (i = 0; i < num_bss; i++) {
+		if (i)
+			fprintf(f, "bss=bench0_%u\nbssid=02:00:00:%02x:%02x:01\n",
+				i, (i >> 8) & 0xff, i & 0xff);
+		fprintf(f,
+			"ssid=bench%u\n"
+			"wpa=2\n"
+			"wpa_key_mgmt=WPA-PSK\n"
+			"rsn_pairwise=CCMP\n"
+			"wpa_psk=0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef\n"
+			"ieee80211n=1\n"
+			"wmm_enabled=1\n"
+			"ignore_broadcast_ssid=0\n"
+			"max_num_sta=255\n"
+			"ap_isolate=1\n"
+			"dtim_period=2\n"
+			"auth_algs=1\n"
+			"macaddr_acl=0\n"
+			"logger_syslog=-1\n"
+			"logger_stdout=-1\n"
+			"logger_stdout_level=2\n",
+			i);
+	}
+
+	return ferror(f) ? -1 : 0;
+}
+
+
+static int config_read_bench(void)
+{
+	static const unsigned int num_bss[] = { 1, 64, 512 };
+	char fname[] = "/tmp/hostapd-config-bench-XXXXXX";
+	struct hostapd_config *conf;
+	struct os_reltime start, age;
+	unsigned int i;
+	FILE *f;
+	int fd, ret = -1;
+
+	for (i = 0; i < ARRAY_SIZE(num_bss); i++) {
+		os_strlcpy(fname + sizeof(fname) - 7, "XXXXXX", 7);
+		fd = mkstemp(fname);
+		if (fd < 0)
+			return -1;
+		f = fdopen(fd, "w");
+		if (!f) {
+			close(fd);
+			goto out;
+		}
+		if (config_read_bench_write(f, num_bss[i]) < 0) {
+			fclose(f);
+			goto out;
+		}
+		fclose(f);
+
+		os_get_reltime(&start);
+		conf = hostapd_config_read(fname);
+		os_reltime_age(&start, &age);
+		unlink(fname);
+		if (!conf || conf->num_bss != num_bss[i]) {
+			wpa_printf(MSG_ERROR,
+				   "config read benchmark: Failed to read %u BSS configuration",
+				   num_bss[i]);
+			hostapd_config_free(conf);
+			return -1;
+		}
+		hostapd_config_free(conf);
+		wpa_printf(MSG_INFO,
+			   "config read benchmark: %u BSS(s) in %u.%06u s",
+			   num_bss[i], (unsigned int) age.sec,
+			   (unsigned int) age.usec);
+	}
+
+	ret = 0;
+out:
+	if (ret)
+		unlink(fname);
+	return ret;
+}
+
+
+static struct hostapd_config * config_read_str(const char *str)
+{
+	char fname[] = "/tmp/hostapd-config-test-XXXXXX";
+	struct hostapd_config *conf;
+	int fd;
+
+	fd = mkstemp(fname);
+	if (fd < 0)
+		return NULL;
+	if (write(fd, str, os_strlen(str)) != (ssize_t) os_strlen(str)) {
+		close(fd);
+		unlink(fname);
+		return NULL;
+	}
+	close(fd);
+	conf = hostapd_config_read(fname);
+	unlink(fname);
+	return conf;
+}
+
+
+static int config_diff_tests(void)
+{
+	const char *old_str =
+		"interface=test0\nchannel=1\nssid=a\n"
+		"bss=test0_1\nbssid=02:00:00:00:00:01\nssid=b\n"
+		"bss=test0_2\nbssid=02:00:00:00:00:02\nssid=c\n";
+	const char *new_str =
+		"interface=test0\nchannel=1\nssid=a\n"
+		"bss=test0_1\nbssid=02:00:00:00:00:01\nssid=b\n"
+		"max_num_sta=10\n"
+		"bss=test0_2\nbssid=02:00:00:00:00:02\nssid=d\n";
+	struct hostapd_config *old_conf, *new_conf;
+	char buf[100];
+	int ret = -1;
+
+	wpa_printf(MSG_INFO, "config diff tests");
+
+	old_conf = config_read_str(old_str);
+	new_conf = config_read_str(new_str);
+	if (!old_conf || !new_conf || old_conf->num_bss != 3 ||
+	    new_conf->num_bss != 3)
+		goto fail;
+
+	if (hostapd_config_bss_diff(old_conf->bss[0], new_conf->bss[0],
+				    buf, sizeof(buf)) != 0 ||
+	    hostapd_config_bss_diff(old_conf->bss[1], new_conf->bss[1],
+				    buf, sizeof(buf)) != 1 ||
+	    os_strcmp(buf, "max_num_sta") != 0 ||
+	    hostapd_config_bss_diff(old_conf->bss[2], new_conf->bss[2],
+				    buf, sizeof(buf)) != 1 ||
+	    os_strcmp(buf, "ssid") != 0)
+		goto fail;
+
+	hostapd_config_mark_modified(old_conf->bss[0]);
+	if (hostapd_config_bss_diff(old_conf->bss[0], new_conf->bss[0],
+				    buf, sizeof(buf)) != -1)
+		goto fail;
+
+	/* Radio parameter set in the section of another BSS */
+	hostapd_config_free(old_conf);
+	hostapd_config_free(new_conf);
+	old_conf = config_read_str(
+		"interface=test0\nssid=a\n"
+		"bss=test0_1\nbssid=02:00:00:00:00:01\nssid=b\nchannel=1\n");
+	new_conf = config_read_str(
+		"interface=test0\nssid=a\n"
+		"bss=test0_1\nbssid=02:00:00:00:00:01\nssid=b\nchannel=6\n");
+	if (!old_conf || !new_conf ||
+	    hostapd_config_bss_diff(old_conf->bss[0], new_conf->bss[0],
+				    buf, sizeof(buf)) != 1 ||
+	    os_strcmp(buf, "channel") != 0)
+		goto fail;
+
+	ret = 0;
+fail:
+	if (ret)
+		wpa_printf(MSG_ERROR, "config diff test failed");
+	hostapd_config_free(old_conf);
+	hostapd_config_free(new_conf);
+	return ret;
+}
+
+
+static int write_str(const char *fname, const char *str)
+{
+	FILE *f;
+	int ret;
+
+	f = fopen(fname, "w");
+	if (!f)
+		return -1;
+	ret = fputs(str, f) < 0 ? -1 : 0;
+	if (fclose(f) != 0)
+		ret = -1;
+	return ret;
+}
+
+
+static int config_diff_file_tests(void)
+{
+	char fname[] = "/tmp/hostapd-accept-test-XXXXXX";
+	char conf_str[200];
+	struct hostapd_config *old_conf = NULL, *new_conf = NULL;
+	char buf[100];
+	int fd, ret = -1;
+
+	wpa_printf(MSG_INFO, "config diff referenced file tests");
+
+	fd = mkstemp(fname);
+	if (fd < 0)
+		return -1;
+	close(fd);
+	os_snprintf(conf_str, sizeof(conf_str),
+		    "interface=test0\nchannel=1\nssid=a\n"
+		    "macaddr_acl=1\naccept_mac_file=%s\n", fname);
+
+	if (write_str(fname, "02:00:00:00:00:01\n") < 0)
+		goto fail;
+	old_conf = config_read_str(conf_str);
+	new_conf = config_read_str(conf_str);
+	if (!old_conf || !new_conf ||
+	    hostapd_config_bss_diff(old_conf->bss[0], new_conf->bss[0],
+				    buf, sizeof(buf)) != 0)
+		goto fail;
+
+	/* Only the contents of the referenced file changes */
+	hostapd_config_free(new_conf);
+	new_conf = NULL;
+	if (write_str(fname, "02:00:00:00:00:02\n") < 0)
+		goto fail;
+	new_conf = config_read_str(conf_str);
+	if (!new_conf ||
+	    hostapd_config_bss_diff(old_conf->bss[0], new_conf->bss[0],
+				    buf, sizeof(buf)) != 1 ||
+	    os_strcmp(buf, "accept_mac_file") != 0)
+		goto fail;
+
+	ret = 0;
+fail:
+	if (ret)
+		wpa_printf(MSG_ERROR, "config diff referenced file test failed");
+	unlink(fname);
+	hostapd_config_free(old_conf);
+	hostapd_config_free(new_conf);
+	return ret;
+}
+
 
 int hapd_module_tests(void)
 {
+	int ret = 0;
+
 	wpa_printf(MSG_INFO, "hostapd module tests");
-	return 0;
+
+	if (config_read_bench() < 0 ||
+	    config_diff_tests() < 0 ||
+	    config_diff_file_tests() < 0)
+		ret = -1;
+
+	return ret;
 }
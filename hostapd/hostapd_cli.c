@@ -721,6 +721,24 @@ static int hostapd_cli_cmd_get_config(struct wpa_ctrl *ctrl, int argc,
 }
 
 
+static int hostapd_cli_cmd_latency_stats(struct wpa_ctrl *ctrl, int argc,
+					 char *argv[])
+{
+	if (argc > 0 && os_strcmp(argv[0], "reset") == 0)
+		return wpa_ctrl_command(ctrl, "LATENCY_STATS reset");
+	return wpa_ctrl_command(ctrl, "LATENCY_STATS");
+}
+
+
+static int hostapd_cli_cmd_ctrl_stats(struct wpa_ctrl *ctrl, int argc,
+				      char *argv[])
+{
+	if (argc > 0 && os_strcmp(argv[0], "reset") == 0)
+		return wpa_ctrl_command(ctrl, "CTRL_STATS reset");
+	return wpa_ctrl_command(ctrl, "CTRL_STATS");
+}
+
+
 static int wpa_ctrl_command_sta(struct wpa_ctrl *ctrl, const char *cmd,
 				char *addr, size_t addr_len, int print)
 {
@@ -790,6 +808,68 @@ static int hostapd_cli_cmd_list_sta(struct wpa_ctrl *ctrl, int argc,
 }
 
 
+static int hostapd_cli_cmd_sta_dump(struct wpa_ctrl *ctrl, int argc,
+				    char *argv[])
+{
+	char cmd[256], buf[4096], *pos, *next;
+	char after[32] = "";
+	size_t len;
+	int i, res, ret;
+
+	if (ctrl_conn == NULL) {
+		printf("Not connected to hostapd - command dropped.\n");
+		return -1;
+	}
+
+	for (;;) {
+		res = os_snprintf(cmd, sizeof(cmd), "STA-DUMP%s%s",
+				  after[0] ? " after=" : "", after);
+		if (os_snprintf_error(sizeof(cmd), res))
+			return -1;
+		for (i = 0; i < argc; i++) {
+			ret = os_snprintf(cmd + res, sizeof(cmd) - res, " %s",
+					  argv[i]);
+			if (os_snprintf_error(sizeof(cmd) - res, ret))
+				return -1;
+			res += ret;
+		}
+
+		len = sizeof(buf) - 1;
+		ret = wpa_ctrl_request(ctrl, cmd, os_strlen(cmd), buf, &len,
+				       hostapd_cli_msg_cb);
+		if (ret == -2) {
+			printf("'%s' command timed out.\n", cmd);
+			return -2;
+		} else if (ret < 0) {
+			printf("'%s' command failed.\n", cmd);
+			return -1;
+		}
+		buf[len] = '\0';
+		if (os_strncmp(buf, "FAIL", 4) == 0) {
+			printf("%s", buf);
+			return -1;
+		}
+
+		/* Continue from the cursor on the last line, if present */
+		next = NULL;
+		pos = buf;
+		while ((pos = os_strstr(pos, "next=")) != NULL) {
+			if (pos == buf || pos[-1] == '\n')
+				next = pos;
+			pos += 5;
+		}
+		if (next)
+			*next = '\0';
+		printf("%s", buf);
+		if (!next)
+			break;
+		os_strlcpy(after, next + 5, 18);
+	}
+
+	return 0;
+}
+
+
 static int hostapd_cli_cmd_help(struct wpa_ctrl *ctrl, int argc, char *argv[])
 {
 	print_help(stdout, argc > 0 ? argv[0] : NULL);
@@ -1548,6 +1628,13 @@ static const struct hostapd_cli_cmd hostapd_cli_commands[] = {
 	   "= get MIB variables for all stations" },
 	{ "list_sta", hostapd_cli_cmd_list_sta, NULL,
 	   "= list all stations" },
+	{ "latency_stats", hostapd_cli_cmd_latency_stats, NULL,
+	  "[reset] = show (or reset) authentication latency statistics" },
+	{ "ctrl_stats", hostapd_cli_cmd_ctrl_stats, NULL,
+	  "[reset] = show (or reset) control interface command statistics" },
+	{ "sta_dump", hostapd_cli_cmd_sta_dump, NULL,
+	  "[max=<count>] [attrs=<attr>[,<attr>...]] = list selected attributes "
+	  "of all stations" },
 	{ "new_sta", hostapd_cli_cmd_new_sta, NULL,
 	  "<addr> = add a new station" },
 	{ "deauthenticate", hostapd_cli_cmd_deauthenticate,
@@ -19,6 +19,7 @@
 #include "crypto/tls.h"
 #include "common/version.h"
 #include "common/dpp.h"
+#include "common/ctrl_iface_common.h"
 #include "drivers/driver.h"
 #include "eap_server/eap.h"
 #include "eap_server/tncs.h"
@@ -487,6 +488,8 @@ static void hostapd_global_deinit(const char *pid_file, int eloop_initialized)
 #endif /* EAP_SERVER_TNC */
 
 	random_deinit();
+	hostapd_config_flush_psk_cache();
+	hostapd_config_flush_sae_pt_cache();
 
 	if (eloop_initialized)
 		eloop_destroy();
@@ -590,6 +593,10 @@ static void usage(void)
 		"   -T   record to Linux tracing in addition to logging\n"
 		"        (records all messages regardless of debug verbosity)\n"
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+		"   -R   record debug messages to a binary trace ring file\n"
+		"        (see wpa_supplicant/utils/debug_ring_decode.py)\n"
+#endif /* CONFIG_DEBUG_RING */
 		"   -i   list of interface names to use\n"
 #ifdef CONFIG_DEBUG_SYSLOG
 		"   -s   log output to syslog instead of stdout\n"
@@ -745,6 +752,9 @@ int main(int argc, char *argv[])
 	int c, debug = 0, daemonize = 0;
 	char *pid_file = NULL;
 	const char *log_file = NULL;
+#ifdef CONFIG_DEBUG_RING
+	const char *ring_file = NULL;
+#endif /* CONFIG_DEBUG_RING */
 	const char *entropy_file = NULL;
 	char **bss_config = NULL, **tmp_bss;
 	size_t num_bss_configs = 0;
@@ -785,9 +795,10 @@ int main(int argc, char *argv[])
 	if (!interfaces.dpp)
 		return -1;
 #endif /* CONFIG_DPP */
+	interfaces.ctrl_stats = ctrl_iface_cmd_stats_init();
 
 	for (;;) {
-		c = getopt(argc, argv, "b:Bde:f:hi:KP:sSTtu:vg:G:");
+		c = getopt(argc, argv, "b:Bde:f:hi:KP:R:sSTtu:vg:G:");
 		if (c < 0)
 			break;
 		switch (c) {
@@ -823,6 +834,11 @@ int main(int argc, char *argv[])
 			enable_trace_dbg = 1;
 			break;
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+		case 'R':
+			ring_file = optarg;
+			break;
+#endif /* CONFIG_DEBUG_RING */
 		case 'v':
 			show_version();
 			exit(1);
@@ -890,6 +906,16 @@ int main(int argc, char *argv[])
 		}
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+	if (ring_file &&
+	    wpa_debug_open_ring(ring_file, WPA_DEBUG_RING_DEFAULT_SIZE,
+				wpa_debug_level < MSG_DEBUG ?
+				wpa_debug_level : MSG_DEBUG)) {
+		wpa_printf(MSG_ERROR, "Failed to open trace ring file %s",
+			   ring_file);
+		return -1;
+	}
+#endif /* CONFIG_DEBUG_RING */
 
 	interfaces.count = argc - optind;
 	if (interfaces.count || num_bss_configs) {
@@ -1018,6 +1044,7 @@ int main(int argc, char *argv[])
 #ifdef CONFIG_DPP
 	dpp_global_deinit(interfaces.dpp);
 #endif /* CONFIG_DPP */
+	ctrl_iface_cmd_stats_deinit(interfaces.ctrl_stats);
 
 	if (interfaces.eloop_initialized)
 		eloop_cancel_timeout(hostapd_periodic, &interfaces, NULL);
@@ -1028,6 +1055,7 @@ int main(int argc, char *argv[])
 	if (log_file)
 		wpa_debug_close_file();
 	wpa_debug_close_linux_tracing();
+	wpa_debug_close_ring();
 
 	os_free(bss_config);
 
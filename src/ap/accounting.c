@@ -218,6 +218,29 @@ static void accounting_interim_update(void *eloop_ctx, void *timeout_ctx)
 }
 
 
+/*
+ * STAs that associate at the same time (e.g., after an AP restart) would
+ * otherwise send all their interim updates within the same second for the
+ * lifetime of the sessions. Delay the first update of each session by an
+ * additional offset of up to one interval to spread them over the full
+ * interval without ever sending an update before the configured interval has
+ * elapsed. The session id is random, so use it as the per-STA offset. The
+ * following updates use the interval and keep this phase.
+ */
+static void accounting_first_update(struct hostapd_data *hapd,
+				    struct sta_info *sta, int interval)
+{
+	u64 delay;
+
+	delay = (u64) interval * 1000000;
+	if (delay)
+		delay += sta->acct_session_id % delay;
+
+	eloop_register_timeout(delay / 1000000, delay % 1000000,
+			       accounting_interim_update, hapd, sta);
+}
+
+
 /**
  * accounting_sta_start - Start STA accounting
  * @hapd: hostapd BSS data
@@ -250,8 +273,7 @@ void accounting_sta_start(struct hostapd_data *hapd, struct sta_info *sta)
 		interval = sta->acct_interim_interval;
 	else
 		interval = ACCT_DEFAULT_UPDATE_INTERVAL;
-	eloop_register_timeout(interval, 0, accounting_interim_update,
-			       hapd, sta);
+	accounting_first_update(hapd, sta, interval);
 
 	msg = accounting_msg(hapd, sta, RADIUS_ACCT_STATUS_TYPE_START);
 	if (msg &&
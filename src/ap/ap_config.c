@@ -10,6 +10,7 @@
 
 #include "utils/common.h"
 #include "crypto/sha1.h"
+#include "crypto/sha256.h"
 #include "crypto/tls.h"
 #include "radius/radius_client.h"
 #include "common/ieee802_11_defs.h"
@@ -292,6 +293,186 @@ int hostapd_mac_comp(const void *a, const void *b)
 }
 
 
+/*
+ * PSKs derived from wpa_psk_file passphrases are cached since the file is read
+ * again on each configuration reload and each passphrase costs 4096
+ * PBKDF2-SHA1 iterations. Entries are looked up by an HMAC-SHA256 of the SSID
+ * and the passphrase with a random per-process key, so the passphrases are not
+ * kept in memory. Each entry belongs to the file (and SSID) it was last seen
+ * with and the entries that are no longer in that file are removed after it
+ * has been read.
+ */
+#define PSK_CACHE_HASH_SIZE 256
+#define PSK_CACHE_MAX_ENTRIES 4096
+
+struct psk_cache_entry {
+	struct psk_cache_entry *hnext; /* next entry in hash table list */
+	struct dl_list list; /* LRU order; most recently used first */
+	u8 id[SHA256_MAC_LEN]; /* HMAC-SHA256 of SSID length, SSID, passphrase */
+	u32 file; /* hash of the file name and SSID the entry was last seen with */
+	unsigned int gen; /* read of that file in which the entry was seen */
+	u8 psk[PMK_LEN];
+};
+
+static struct psk_cache_entry *psk_cache_hash[PSK_CACHE_HASH_SIZE];
+static struct dl_list psk_cache_lru = DL_LIST_HEAD_INIT(psk_cache_lru);
+static unsigned int psk_cache_entries;
+static unsigned int psk_cache_gen;
+static u8 psk_cache_key[32];
+static int psk_cache_key_set;
+
+
+static int psk_cache_id(const struct hostapd_ssid *ssid,
+			const char *passphrase, u8 *id)
+{
+	const u8 *addr[3];
+	size_t len[3];
+	u8 ssid_len = ssid->ssid_len;
+
+	if (!psk_cache_key_set) {
+		if (os_get_random(psk_cache_key, sizeof(psk_cache_key)) < 0)
+			return -1;
+		psk_cache_key_set = 1;
+	}
+
+	addr[0] = &ssid_len;
+	len[0] = 1;
+	addr[1] = ssid->ssid;
+	len[1] = ssid->ssid_len;
+	addr[2] = (const u8 *) passphrase;
+	len[2] = os_strlen(passphrase);
+	return hmac_sha256_vector(psk_cache_key, sizeof(psk_cache_key), 3,
+				  addr, len, id);
+}
+
+
+/* The same file can be used with different SSIDs in separate BSSs */
+static u32 psk_cache_file_hash(const char *fname,
+			       const struct hostapd_ssid *ssid)
+{
+	u32 hash = 2166136261U;
+	size_t i;
+
+	for (; *fname; fname++)
+		hash = (hash ^ (u8) *fname) * 16777619U;
+	for (i = 0; i < ssid->ssid_len; i++)
+		hash = (hash ^ ssid->ssid[i]) * 16777619U;
+	return hash;
+}
+
+
+static unsigned int psk_cache_hash_key(const u8 *id)
+{
+	return id[0] % PSK_CACHE_HASH_SIZE;
+}
+
+
+static void psk_cache_entry_free(struct psk_cache_entry *entry)
+{
+	struct psk_cache_entry **pos;
+
+	pos = &psk_cache_hash[psk_cache_hash_key(entry->id)];
+	while (*pos) {
+		if (*pos == entry) {
+			*pos = entry->hnext;
+			break;
+		}
+		pos = &(*pos)->hnext;
+	}
+	dl_list_del(&entry->list);
+	psk_cache_entries--;
+	bin_clear_free(entry, sizeof(*entry));
+}
+
+
+static int hostapd_config_derive_file_psk(struct hostapd_ssid *ssid,
+					  const char *passphrase, u32 file,
+					  u8 *psk)
+{
+	struct psk_cache_entry *entry;
+	unsigned int idx;
+	size_t len = os_strlen(passphrase);
+	u8 id[SHA256_MAC_LEN];
+
+	if (len < 8 || len > 63 || ssid->ssid_len > SSID_MAX_LEN)
+		return -1;
+
+	if (psk_cache_id(ssid, passphrase, id) < 0)
+		return pbkdf2_sha1(passphrase, ssid->ssid, ssid->ssid_len,
+				   4096, psk, PMK_LEN);
+
+	idx = psk_cache_hash_key(id);
+	for (entry = psk_cache_hash[idx]; entry; entry = entry->hnext) {
+		if (os_memcmp(entry->id, id, sizeof(id)) == 0) {
+			dl_list_del(&entry->list);
+			dl_list_add(&psk_cache_lru, &entry->list);
+			entry->file = file;
+			entry->gen = psk_cache_gen;
+			os_memcpy(psk, entry->psk, PMK_LEN);
+			return 0;
+		}
+	}
+
+	if (pbkdf2_sha1(passphrase, ssid->ssid, ssid->ssid_len, 4096,
+			psk, PMK_LEN) < 0)
+		return -1;
+
+	entry = os_zalloc(sizeof(*entry));
+	if (!entry)
+		return 0;
+	os_memcpy(entry->id, id, sizeof(id));
+	entry->file = file;
+	entry->gen = psk_cache_gen;
+	os_memcpy(entry->psk, psk, PMK_LEN);
+	entry->hnext = psk_cache_hash[idx];
+	psk_cache_hash[idx] = entry;
+	dl_list_add(&psk_cache_lru, &entry->list);
+	psk_cache_entries++;
+
+	if (psk_cache_entries > PSK_CACHE_MAX_ENTRIES) {
+		entry = dl_list_last(&psk_cache_lru, struct psk_cache_entry,
+				     list);
+		psk_cache_entry_free(entry);
+	}
+
+	return 0;
+}
+
+
+/* Remove the entries of a file that were not seen in its latest read */
+static void psk_cache_expire_file(const char *fname, u32 file)
+{
+	struct psk_cache_entry *entry, *tmp;
+	unsigned int removed = 0;
+
+	dl_list_for_each_safe(entry, tmp, &psk_cache_lru,
+			      struct psk_cache_entry, list) {
+		if (entry->file == file && entry->gen != psk_cache_gen) {
+			psk_cache_entry_free(entry);
+			removed++;
+		}
+	}
+	wpa_printf(MSG_DEBUG,
+		   "WPA PSK file '%s': removed %u cached PSKs (%u cached)",
+		   fname, removed, psk_cache_entries);
+}
+
+
+/**
+ * hostapd_config_flush_psk_cache - Free the cached wpa_psk_file PSKs
+ */
+void hostapd_config_flush_psk_cache(void)
+{
+	struct psk_cache_entry *entry, *tmp;
+
+	dl_list_for_each_safe(entry, tmp, &psk_cache_lru,
+			      struct psk_cache_entry, list)
+		psk_cache_entry_free(entry);
+	forced_memzero(psk_cache_key, sizeof(psk_cache_key));
+	psk_cache_key_set = 0;
+}
+
+
 static int hostapd_config_read_wpa_psk(const char *fname,
 				       struct hostapd_ssid *ssid)
 {
@@ -306,6 +487,7 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 	int line = 0, ret = 0, len, ok;
 	u8 addr[ETH_ALEN];
 	struct hostapd_wpa_psk *psk;
+	u32 file;
 
 	if (!fname)
 		return 0;
@@ -316,6 +498,9 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 		return -1;
 	}
 
+	file = psk_cache_file_hash(fname, ssid);
+	psk_cache_gen++;
+
 	while (fgets(buf, sizeof(buf), f)) {
 		int vlan_id = 0;
 		int wps = 0;
@@ -402,8 +587,8 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 		    hexstr2bin(pos, psk->psk, PMK_LEN) == 0)
 			ok = 1;
 		else if (len >= 8 && len < 64 &&
-			 pbkdf2_sha1(pos, ssid->ssid, ssid->ssid_len,
-				     4096, psk->psk, PMK_LEN) == 0)
+			 hostapd_config_derive_file_psk(ssid, pos, file,
+							psk->psk) == 0)
 			ok = 1;
 		if (!ok) {
 			wpa_printf(MSG_ERROR,
@@ -434,6 +619,9 @@ static int hostapd_config_read_wpa_psk(const char *fname,
 
 	fclose(f);
 
+	if (ret == 0)
+		psk_cache_expire_file(fname, file);
+
 	return ret;
 }
 
@@ -459,6 +647,223 @@ static int hostapd_derive_psk(struct hostapd_ssid *ssid)
 }
 
 
+#ifdef CONFIG_SAE
+
+/*
+ * SAE H2E PTs are cached by (group, SSID, password, password identifier) so
+ * that configuration reloads do not need to run the hash-to-element
+ * derivation again for each password and group.
+ */
+#define SAE_PT_CACHE_HASH_SIZE 256
+#define SAE_PT_CACHE_MAX_ENTRIES 1024
+
+struct sae_pt_cache_entry {
+	struct sae_pt_cache_entry *hnext; /* next entry in hash table list */
+	struct dl_list list; /* LRU order; most recently used first */
+	int group;
+	u8 ssid[SSID_MAX_LEN];
+	size_t ssid_len;
+	u8 *password;
+	size_t password_len;
+	char *identifier;
+	u8 *pt;
+	size_t pt_len;
+};
+
+static struct sae_pt_cache_entry *sae_pt_cache_hash[SAE_PT_CACHE_HASH_SIZE];
+static struct dl_list sae_pt_cache_lru = DL_LIST_HEAD_INIT(sae_pt_cache_lru);
+static unsigned int sae_pt_cache_entries;
+
+
+static unsigned int sae_pt_cache_hash_key(int group, const u8 *ssid,
+					  size_t ssid_len, const u8 *password,
+					  size_t password_len,
+					  const char *identifier)
+{
+	u32 hash = 2166136261U ^ group;
+	size_t i;
+
+	for (i = 0; i < ssid_len; i++)
+		hash = (hash ^ ssid[i]) * 16777619U;
+	for (i = 0; i < password_len; i++)
+		hash = (hash ^ password[i]) * 16777619U;
+	for (; identifier && *identifier; identifier++)
+		hash = (hash ^ (u8) *identifier) * 16777619U;
+
+	return hash % SAE_PT_CACHE_HASH_SIZE;
+}
+
+
+static void sae_pt_cache_entry_free(struct sae_pt_cache_entry *entry)
+{
+	struct sae_pt_cache_entry **pos;
+
+	pos = &sae_pt_cache_hash[sae_pt_cache_hash_key(
+			entry->group, entry->ssid, entry->ssid_len,
+			entry->password, entry->password_len,
+			entry->identifier)];
+	while (*pos) {
+		if (*pos == entry) {
+			*pos = entry->hnext;
+			break;
+		}
+		pos = &(*pos)->hnext;
+	}
+	dl_list_del(&entry->list);
+	sae_pt_cache_entries--;
+	bin_clear_free(entry->password, entry->password_len);
+	str_clear_free(entry->identifier);
+	bin_clear_free(entry->pt, entry->pt_len);
+	os_free(entry);
+}
+
+
+static struct sae_pt_cache_entry *
+sae_pt_cache_get(int group, const u8 *ssid, size_t ssid_len,
+		 const u8 *password, size_t password_len,
+		 const char *identifier)
+{
+	struct sae_pt_cache_entry *entry;
+	unsigned int idx;
+
+	idx = sae_pt_cache_hash_key(group, ssid, ssid_len, password,
+				    password_len, identifier);
+	for (entry = sae_pt_cache_hash[idx]; entry; entry = entry->hnext) {
+		if (entry->group == group &&
+		    entry->ssid_len == ssid_len &&
+		    os_memcmp(entry->ssid, ssid, ssid_len) == 0 &&
+		    entry->password_len == password_len &&
+		    os_memcmp(entry->password, password, password_len) == 0 &&
+		    ((!entry->identifier && !identifier) ||
+		     (entry->identifier && identifier &&
+		      os_strcmp(entry->identifier, identifier) == 0)))
+			return entry;
+	}
+
+	return NULL;
+}
+
+
+static void sae_pt_cache_add(const struct sae_pt *pt, const u8 *ssid,
+			     size_t ssid_len, const u8 *password,
+			     size_t password_len, const char *identifier)
+{
+	struct sae_pt_cache_entry *entry;
+	u8 bin[SAE_MAX_PRIME_LEN];
+	unsigned int idx;
+	int len;
+
+	if (ssid_len > SSID_MAX_LEN)
+		return;
+	len = sae_pt_to_bin(pt, bin, sizeof(bin));
+	if (len < 0)
+		return;
+
+	entry = os_zalloc(sizeof(*entry));
+	if (!entry)
+		goto out;
+	entry->group = pt->group;
+	os_memcpy(entry->ssid, ssid, ssid_len);
+	entry->ssid_len = ssid_len;
+	entry->password = os_memdup(password, password_len);
+	entry->password_len = password_len;
+	if (identifier)
+		entry->identifier = os_strdup(identifier);
+	entry->pt = os_memdup(bin, len);
+	entry->pt_len = len;
+	if ((!entry->password && password_len) ||
+	    (identifier && !entry->identifier) || !entry->pt) {
+		bin_clear_free(entry->password, entry->password_len);
+		str_clear_free(entry->identifier);
+		bin_clear_free(entry->pt, entry->pt_len);
+		os_free(entry);
+		goto out;
+	}
+
+	idx = sae_pt_cache_hash_key(entry->group, ssid, ssid_len, password,
+				    password_len, identifier);
+	entry->hnext = sae_pt_cache_hash[idx];
+	sae_pt_cache_hash[idx] = entry;
+	dl_list_add(&sae_pt_cache_lru, &entry->list);
+	sae_pt_cache_entries++;
+
+	if (sae_pt_cache_entries > SAE_PT_CACHE_MAX_ENTRIES) {
+		entry = dl_list_last(&sae_pt_cache_lru,
+				     struct sae_pt_cache_entry, list);
+		sae_pt_cache_entry_free(entry);
+	}
+out:
+	forced_memzero(bin, sizeof(bin));
+}
+
+
+static struct sae_pt * hostapd_sae_derive_pt(int *groups, const u8 *ssid,
+					     size_t ssid_len,
+					     const u8 *password,
+					     size_t password_len,
+					     const char *identifier)
+{
+	struct sae_pt *pt = NULL, *last = NULL, *tmp;
+	struct sae_pt_cache_entry *entry;
+	int default_groups[] = { 19, 0 };
+	int group[2] = { 0, 0 };
+	int i;
+
+	if (!groups)
+		groups = default_groups;
+	for (i = 0; groups[i] > 0; i++) {
+		tmp = NULL;
+		entry = sae_pt_cache_get(groups[i], ssid, ssid_len, password,
+					 password_len, identifier);
+		if (entry) {
+			tmp = sae_pt_from_bin(groups[i], ssid, ssid_len,
+					      entry->pt, entry->pt_len);
+			if (tmp) {
+				wpa_printf(MSG_DEBUG,
+					   "SAE: Use cached PT - group %d",
+					   groups[i]);
+				dl_list_del(&entry->list);
+				dl_list_add(&sae_pt_cache_lru, &entry->list);
+			}
+		}
+		if (!tmp) {
+			group[0] = groups[i];
+			tmp = sae_derive_pt(group, ssid, ssid_len, password,
+					    password_len, identifier);
+			if (!tmp)
+				continue;
+			sae_pt_cache_add(tmp, ssid, ssid_len, password,
+					 password_len, identifier);
+		}
+
+		if (last)
+			last->next = tmp;
+		else
+			pt = tmp;
+		last = tmp;
+	}
+
+	return pt;
+}
+
+#endif /* CONFIG_SAE */
+
+
+/**
+ * hostapd_config_flush_sae_pt_cache - Free the cached SAE PTs
+ */
+void hostapd_config_flush_sae_pt_cache(void)
+{
+#ifdef CONFIG_SAE
+	struct sae_pt_cache_entry *entry, *tmp;
+
+	dl_list_for_each_safe(entry, tmp, &sae_pt_cache_lru,
+			      struct sae_pt_cache_entry, list)
+		sae_pt_cache_entry_free(entry);
+#endif /* CONFIG_SAE */
+}
+
+
 int hostapd_setup_sae_pt(struct hostapd_bss_config *conf)
 {
 #ifdef CONFIG_SAE
@@ -474,22 +879,21 @@ int hostapd_setup_sae_pt(struct hostapd_bss_config *conf)
 	sae_deinit_pt(ssid->pt);
 	ssid->pt = NULL;
 	if (ssid->wpa_passphrase) {
-		ssid->pt = sae_derive_pt(conf->sae_groups, ssid->ssid,
-					 ssid->ssid_len,
-					 (const u8 *) ssid->wpa_passphrase,
-					 os_strlen(ssid->wpa_passphrase),
-					 NULL);
+		ssid->pt = hostapd_sae_derive_pt(
+			conf->sae_groups, ssid->ssid, ssid->ssid_len,
+			(const u8 *) ssid->wpa_passphrase,
+			os_strlen(ssid->wpa_passphrase), NULL);
 		if (!ssid->pt)
 			return -1;
 	}
 
 	for (pw = conf->sae_passwords; pw; pw = pw->next) {
 		sae_deinit_pt(pw->pt);
-		pw->pt = sae_derive_pt(conf->sae_groups, ssid->ssid,
-				       ssid->ssid_len,
-				       (const u8 *) pw->password,
-				       os_strlen(pw->password),
-				       pw->identifier);
+		pw->pt = hostapd_sae_derive_pt(conf->sae_groups, ssid->ssid,
+					       ssid->ssid_len,
+					       (const u8 *) pw->password,
+					       os_strlen(pw->password),
+					       pw->identifier);
 		if (!pw->pt)
 			return -1;
 	}
@@ -791,6 +1195,7 @@ void hostapd_config_free_bss(struct hostapd_bss_config *conf)
 	os_free(conf->ocsp_stapling_response);
 	os_free(conf->ocsp_stapling_response_multi);
 	os_free(conf->dh_file);
+	os_free(conf->tls_session_cache_file);
 	os_free(conf->openssl_ciphers);
 	os_free(conf->openssl_ecdh_curves);
 	os_free(conf->pac_opaque_encr_key);
@@ -955,6 +1360,8 @@ void hostapd_config_free_bss(struct hostapd_bss_config *conf)
 	}
 #endif /* CONFIG_AIRTIME_POLICY */
 
+	wpabuf_clear_free(conf->conf_items);
+
 	os_free(conf);
 }
 
@@ -1078,12 +1485,37 @@ const char * hostapd_get_vlan_id_ifname(struct hostapd_vlan *vlan, int vlan_id)
 }
 
 
+static int hostapd_psk_match(const struct hostapd_wpa_psk *psk,
+			     const u8 *addr, const u8 *p2p_dev_addr)
+{
+	return psk->group ||
+		(addr && os_memcmp(psk->addr, addr, ETH_ALEN) == 0) ||
+		(!addr && p2p_dev_addr &&
+		 os_memcmp(psk->p2p_dev_addr, p2p_dev_addr, ETH_ALEN) == 0);
+}
+
+
+/**
+ * hostapd_get_psk - Get the next candidate PSK for a STA
+ * @conf: BSS configuration
+ * @addr: STA address
+ * @p2p_dev_addr: P2P Device Address of the STA or %NULL
+ * @prev_psk: Previously returned PSK or %NULL to start from the beginning
+ * @hint_psk: PSK value to try first (e.g., the one that matched on the
+ *	previous association) or %NULL for configuration order
+ * @vlan_id: Buffer for returning the VLAN ID of the PSK entry or %NULL
+ * Returns: Pointer to the PSK or %NULL if there are no more candidates
+ *
+ * If @hint_psk matches one of the candidate PSK entries, that entry is
+ * returned first and the remaining candidates follow in configuration order.
+ */
 const u8 * hostapd_get_psk(const struct hostapd_bss_config *conf,
 			   const u8 *addr, const u8 *p2p_dev_addr,
-			   const u8 *prev_psk, int *vlan_id)
+			   const u8 *prev_psk, const u8 *hint_psk,
+			   int *vlan_id)
 {
-	struct hostapd_wpa_psk *psk;
-	int next_ok = prev_psk == NULL;
+	struct hostapd_wpa_psk *psk, *hint = NULL;
+	int next_ok;
 
 	if (vlan_id)
 		*vlan_id = 0;
@@ -1099,13 +1531,31 @@ const u8 * hostapd_get_psk(const struct hostapd_bss_config *conf,
 			   MAC2STR(addr), prev_psk);
 	}
 
+	if (hint_psk) {
+		for (psk = conf->ssid.wpa_psk; psk; psk = psk->next) {
+			if (hostapd_psk_match(psk, addr, p2p_dev_addr) &&
+			    os_memcmp_const(psk->psk, hint_psk, PMK_LEN) == 0) {
+				hint = psk;
+				break;
+			}
+		}
+	}
+
+	if (hint && !prev_psk) {
+		wpa_printf(MSG_DEBUG, "Trying the previously matching PSK first");
+		if (vlan_id)
+			*vlan_id = hint->vlan_id;
+		return hint->psk;
+	}
+	if (hint && prev_psk == hint->psk)
+		prev_psk = NULL;
+	next_ok = prev_psk == NULL;
+
 	for (psk = conf->ssid.wpa_psk; psk != NULL; psk = psk->next) {
-		if (next_ok &&
-		    (psk->group ||
-		     (addr && os_memcmp(psk->addr, addr, ETH_ALEN) == 0) ||
-		     (!addr && p2p_dev_addr &&
-		      os_memcmp(psk->p2p_dev_addr, p2p_dev_addr, ETH_ALEN) ==
-		      0))) {
+		if (psk == hint)
+			continue;
+
+		if (next_ok && hostapd_psk_match(psk, addr, p2p_dev_addr)) {
 			if (vlan_id)
 				*vlan_id = psk->vlan_id;
 			return psk->psk;
@@ -1556,3 +2006,154 @@ bool hostapd_sae_pk_exclusively(struct hostapd_bss_config *conf)
 	return with_pk;
 }
 #endif /* CONFIG_SAE_PK */
+
+
+int hostapd_config_add_item(struct hostapd_bss_config *bss, const char *name,
+			    const char *value)
+{
+	size_t name_len = os_strlen(name), value_len = os_strlen(value);
+
+	if (wpabuf_resize(&bss->conf_items, name_len + value_len + 2) < 0)
+		return -1;
+	wpabuf_put_data(bss->conf_items, name, name_len);
+	wpabuf_put_u8(bss->conf_items, '=');
+	wpabuf_put_data(bss->conf_items, value, value_len);
+	wpabuf_put_u8(bss->conf_items, '\n');
+	return 0;
+}
+
+
+/**
+ * hostapd_config_mark_modified - Mark BSS configuration modified at runtime
+ * @bss: BSS configuration
+ *
+ * The BSS will be fully reconfigured on the next configuration reload
+ * regardless of whether its lines in the configuration file changed.
+ */
+void hostapd_config_mark_modified(struct hostapd_bss_config *bss)
+{
+	wpabuf_clear_free(bss->conf_items);
+	bss->conf_items = NULL;
+}
+
+
+static const char * conf_items_eol(const char *pos, const char *end)
+{
+	while (pos < end && *pos != '\n')
+		pos++;
+	return pos;
+}
+
+
+static const char * conf_items_find(const char *pos, const char *end,
+				    const char *name, size_t name_len,
+				    const char **next)
+{
+	const char *nl;
+
+	while (pos < end) {
+		nl = conf_items_eol(pos, end);
+		if ((size_t) (nl - pos) > name_len && pos[name_len] == '=' &&
+		    os_memcmp(pos, name, name_len) == 0) {
+			*next = nl < end ? nl + 1 : end;
+			return pos;
+		}
+		pos = nl + 1;
+	}
+
+	return NULL;
+}
+
+
+static bool conf_items_equal(const struct wpabuf *a, const struct wpabuf *b,
+			     const char *name, size_t name_len)
+{
+	const char *pa = wpabuf_head(a), *ea = pa + wpabuf_len(a);
+	const char *pb = wpabuf_head(b), *eb = pb + wpabuf_len(b);
+	const char *na, *nb;
+
+	/* Compare the sequence of values configured for the item */
+	for (;;) {
+		pa = conf_items_find(pa, ea, name, name_len, &na);
+		pb = conf_items_find(pb, eb, name, name_len, &nb);
+		if (!pa || !pb)
+			return !pa && !pb;
+		if (na - pa != nb - pb || os_memcmp(pa, pb, na - pa) != 0)
+			return false;
+		pa = na;
+		pb = nb;
+	}
+}
+
+
+static void conf_items_add_name(char **pos, char *end, const char *name,
+				size_t name_len, int count)
+{
+	int ret;
+
+	ret = os_snprintf(*pos, end - *pos, "%s%.*s", count ? "," : "",
+			  (int) name_len, name);
+	if (!os_snprintf_error(end - *pos, ret))
+		*pos += ret;
+}
+
+
+/**
+ * hostapd_config_bss_diff - Compare two versions of a BSS configuration
+ * @old_bss: Currently used BSS configuration
+ * @new_bss: BSS configuration from the reloaded configuration file
+ * @buf: Buffer for comma separated names of the changed items
+ * @buflen: Length of buf
+ * Returns: Number of changed configuration items or -1 if the BSS cannot be
+ * compared (not read from a file or modified at runtime)
+ */
+int hostapd_config_bss_diff(const struct hostapd_bss_config *old_bss,
+			    const struct hostapd_bss_config *new_bss,
+			    char *buf, size_t buflen)
+{
+	const struct wpabuf *a = old_bss->conf_items, *b = new_bss->conf_items;
+	const char *line, *eq, *nl, *next, *start, *end;
+	char *pos = buf, *bend = buf + buflen;
+	int count = 0;
+
+	if (buflen)
+		buf[0] = '\0';
+	if (!a || !b)
+		return -1;
+
+	/* Items present in the old configuration */
+	start = wpabuf_head(a);
+	end = start + wpabuf_len(a);
+	for (line = start; line < end; line = nl + 1) {
+		nl = conf_items_eol(line, end);
+		for (eq = line; eq < nl && *eq != '='; eq++)
+			;
+		if (eq == nl)
+			continue;
+		if (conf_items_find(start, line, line, eq - line, &next))
+			continue; /* already compared */
+		if (!conf_items_equal(a, b, line, eq - line))
+			conf_items_add_name(&pos, bend, line, eq - line,
+					    count++);
+	}
+
+	/* Items added in the new configuration */
+	start = wpabuf_head(b);
+	end = start + wpabuf_len(b);
+	for (line = start; line < end; line = nl + 1) {
+		nl = conf_items_eol(line, end);
+		for (eq = line; eq < nl && *eq != '='; eq++)
+			;
+		if (eq == nl)
+			continue;
+		if (conf_items_find(start, line, line, eq - line, &next) ||
+		    conf_items_find(wpabuf_head(a),
+				    (const char *) wpabuf_head(a) +
+				    wpabuf_len(a),
+				    line, eq - line, &next))
+			continue;
+		conf_items_add_name(&pos, bend, line, eq - line, count++);
+	}
+
+	return count;
+}
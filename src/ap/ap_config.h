@@ -415,6 +415,8 @@ struct hostapd_bss_config {
 	int check_crl_strict;
 	unsigned int crl_reload_interval;
 	unsigned int tls_session_lifetime;
+	unsigned int tls_session_cache_size;
+	char *tls_session_cache_file;
 	unsigned int tls_flags;
 	unsigned int max_auth_rounds;
 	unsigned int max_auth_rounds_short;
@@ -861,6 +863,17 @@ struct hostapd_bss_config {
 	 */
 	u8 mka_psk_set;
 #endif /* CONFIG_MACSEC */
+
+	/**
+	 * conf_items - Configuration file lines that defined this BSS
+	 *
+	 * Items that reference other files (e.g., accept_mac_file) include a
+	 * hash of the file contents. Radio parameters are recorded for the
+	 * first BSS even if they are set in another BSS section. This is used
+	 * to determine which BSSs are affected by a configuration reload. NULL
+	 * if the BSS was not read from a file or has been modified at runtime.
+	 */
+	struct wpabuf *conf_items;
 };
 
 /**
@@ -1129,8 +1142,11 @@ int hostapd_maclist_found(struct mac_acl_entry *list, int num_entries,
 int hostapd_rate_found(int *list, int rate);
 const u8 * hostapd_get_psk(const struct hostapd_bss_config *conf,
 			   const u8 *addr, const u8 *p2p_dev_addr,
-			   const u8 *prev_psk, int *vlan_id);
+			   const u8 *prev_psk, const u8 *hint_psk,
+			   int *vlan_id);
 int hostapd_setup_wpa_psk(struct hostapd_bss_config *conf);
+void hostapd_config_flush_psk_cache(void);
+void hostapd_config_flush_sae_pt_cache(void);
 int hostapd_vlan_valid(struct hostapd_vlan *vlan,
 		       struct vlan_description *vlan_desc);
 const char * hostapd_get_vlan_id_ifname(struct hostapd_vlan *vlan,
@@ -1142,6 +1158,12 @@ int hostapd_config_check(struct hostapd_config *conf, int full_config);
 void hostapd_set_security_params(struct hostapd_bss_config *bss,
 				 int full_config);
 int hostapd_sae_pw_id_in_use(struct hostapd_bss_config *conf);
+int hostapd_config_add_item(struct hostapd_bss_config *bss, const char *name,
+			    const char *value);
+void hostapd_config_mark_modified(struct hostapd_bss_config *bss);
+int hostapd_config_bss_diff(const struct hostapd_bss_config *old_bss,
+			    const struct hostapd_bss_config *new_bss,
+			    char *buf, size_t buflen);
 bool hostapd_sae_pk_in_use(struct hostapd_bss_config *conf);
 bool hostapd_sae_pk_exclusively(struct hostapd_bss_config *conf);
 int hostapd_setup_sae_pt(struct hostapd_bss_config *conf);
@@ -239,6 +239,10 @@ int authsrv_init(struct hostapd_data *hapd)
 
 		os_memset(&conf, 0, sizeof(conf));
 		conf.tls_session_lifetime = hapd->conf->tls_session_lifetime;
+		conf.tls_session_cache_size =
+			hapd->conf->tls_session_cache_size;
+		conf.tls_session_cache_file =
+			hapd->conf->tls_session_cache_file;
 		if (hapd->conf->crl_reload_interval > 0 &&
 		    hapd->conf->check_crl <= 0) {
 			wpa_printf(MSG_INFO,
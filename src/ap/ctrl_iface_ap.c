@@ -452,6 +452,241 @@ int hostapd_ctrl_iface_sta_next(struct hostapd_data *hapd, const char *txtaddr,
 }
 
 
+#define STA_DUMP_FLAGS BIT(0)
+#define STA_DUMP_AID BIT(1)
+#define STA_DUMP_CAPABILITY BIT(2)
+#define STA_DUMP_LISTEN_INTERVAL BIT(3)
+#define STA_DUMP_CONNECTED_TIME BIT(4)
+#define STA_DUMP_VLAN_ID BIT(5)
+#define STA_DUMP_SAE_GROUP BIT(6)
+#define STA_DUMP_TX_RX BIT(7)
+#define STA_DUMP_DEFAULT (STA_DUMP_FLAGS | STA_DUMP_AID | \
+			  STA_DUMP_CONNECTED_TIME)
+
+static const struct {
+	const char *name;
+	unsigned int attr;
+} sta_dump_attrs[] = {
+	{ "flags", STA_DUMP_FLAGS },
+	{ "aid", STA_DUMP_AID },
+	{ "capability", STA_DUMP_CAPABILITY },
+	{ "listen_interval", STA_DUMP_LISTEN_INTERVAL },
+	{ "connected_time", STA_DUMP_CONNECTED_TIME },
+	{ "vlan_id", STA_DUMP_VLAN_ID },
+	{ "sae_group", STA_DUMP_SAE_GROUP },
+	{ "tx_rx", STA_DUMP_TX_RX },
+	{ "all", ~0U },
+};
+
+
+static int hostapd_sta_dump_parse_attrs(const char *pos, unsigned int *attrs)
+{
+	const char *end;
+	size_t i, len;
+
+	*attrs = 0;
+	while (*pos && *pos != ' ') {
+		end = pos;
+		while (*end && *end != ',' && *end != ' ')
+			end++;
+		len = end - pos;
+		for (i = 0; i < ARRAY_SIZE(sta_dump_attrs); i++) {
+			if (os_strlen(sta_dump_attrs[i].name) == len &&
+			    os_strncmp(sta_dump_attrs[i].name, pos, len) == 0)
+				break;
+		}
+		if (i == ARRAY_SIZE(sta_dump_attrs))
+			return -1;
+		*attrs |= sta_dump_attrs[i].attr;
+		pos = *end == ',' ? end + 1 : end;
+	}
+
+	return 0;
+}
+
+
+static int hostapd_sta_dump_line(struct hostapd_data *hapd,
+				 struct sta_info *sta, unsigned int attrs,
+				 char *buf, size_t buflen)
+{
+	struct hostap_sta_driver_data data;
+	struct os_reltime age;
+	int len = 0, ret;
+
+	ret = os_snprintf(buf, buflen, MACSTR, MAC2STR(sta->addr));
+	if (os_snprintf_error(buflen, ret))
+		return -1;
+	len += ret;
+
+	if (attrs & STA_DUMP_FLAGS) {
+		ret = os_snprintf(buf + len, buflen - len, " flags=");
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+		ret = ap_sta_flags_txt(sta->flags, buf + len, buflen - len);
+		if (ret < 0 || (size_t) ret >= buflen - len)
+			return -1;
+		len += ret;
+	}
+
+	if (attrs & STA_DUMP_AID) {
+		ret = os_snprintf(buf + len, buflen - len, " aid=%d", sta->aid);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+	if (attrs & STA_DUMP_CAPABILITY) {
+		ret = os_snprintf(buf + len, buflen - len, " capability=0x%x",
+				  sta->capability);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+	if (attrs & STA_DUMP_LISTEN_INTERVAL) {
+		ret = os_snprintf(buf + len, buflen - len,
+				  " listen_interval=%d", sta->listen_interval);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+	if ((attrs & STA_DUMP_CONNECTED_TIME) && sta->connected_time.sec) {
+		os_reltime_age(&sta->connected_time, &age);
+		ret = os_snprintf(buf + len, buflen - len,
+				  " connected_time=%u", (unsigned int) age.sec);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+	if ((attrs & STA_DUMP_VLAN_ID) && sta->vlan_id > 0) {
+		ret = os_snprintf(buf + len, buflen - len, " vlan_id=%d",
+				  sta->vlan_id);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+#ifdef CONFIG_SAE
+	if ((attrs & STA_DUMP_SAE_GROUP) && sta->sae &&
+	    sta->sae->state == SAE_ACCEPTED) {
+		ret = os_snprintf(buf + len, buflen - len, " sae_group=%d",
+				  sta->sae->group);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+#endif /* CONFIG_SAE */
+
+	if ((attrs & STA_DUMP_TX_RX) &&
+	    hostapd_drv_read_sta_data(hapd, &data, sta->addr) == 0) {
+		ret = os_snprintf(buf + len, buflen - len,
+				  " rx_packets=%lu tx_packets=%lu"
+				  " rx_bytes=%llu tx_bytes=%llu"
+				  " inactive_msec=%lu signal=%d",
+				  data.rx_packets, data.tx_packets,
+				  data.rx_bytes, data.tx_bytes,
+				  data.inactive_msec, data.signal);
+		if (os_snprintf_error(buflen - len, ret))
+			return -1;
+		len += ret;
+	}
+
+	ret = os_snprintf(buf + len, buflen - len, "\n");
+	if (os_snprintf_error(buflen - len, ret))
+		return -1;
+	len += ret;
+
+	return len;
+}
+
+
+static int hostapd_sta_addr_cmp(const void *a, const void *b)
+{
+	const struct sta_info *sa = *(const struct sta_info **) a;
+	const struct sta_info *sb = *(const struct sta_info **) b;
+
+	return os_memcmp(sa->addr, sb->addr, ETH_ALEN);
+}
+
+
+/*
+ * STA-DUMP [after=<addr>] [max=<count>] [attrs=<attr>[,<attr>...]]
+ *
+ * Reports one line per station in station address order. If not all
+ * stations fit in the response, the last line is "next=<addr>" and the
+ * remaining stations can be fetched with after=<addr>. Using the address
+ * as the cursor keeps paging consistent when stations are added or
+ * removed between requests.
+ */
+int hostapd_ctrl_iface_sta_dump(struct hostapd_data *hapd, const char *cmd,
+				char *buf, size_t buflen)
+{
+	u8 after[ETH_ALEN];
+	struct sta_info *sta, **stas;
+	unsigned int attrs = STA_DUMP_DEFAULT;
+	size_t i, num = 0, max = (size_t) -1;
+	/* room for the "next=<addr>" line */
+	const size_t next_len = 5 + 17 + 1;
+	const char *pos;
+	int len = 0, ret;
+
+	os_memset(after, 0, ETH_ALEN);
+	pos = os_strstr(cmd, "after=");
+	if (pos && hwaddr_aton(pos + 6, after))
+		return -1;
+	pos = os_strstr(cmd, "max=");
+	if (pos) {
+		max = atoi(pos + 4);
+		if (max == 0)
+			return -1;
+	}
+	pos = os_strstr(cmd, "attrs=");
+	if (pos && hostapd_sta_dump_parse_attrs(pos + 6, &attrs) < 0)
+		return -1;
+
+	if (buflen <= next_len)
+		return -1;
+
+	if (!hapd->num_sta)
+		return 0;
+	stas = os_calloc(hapd->num_sta, sizeof(*stas));
+	if (!stas)
+		return -1;
+	for (sta = hapd->sta_list; sta && num < (size_t) hapd->num_sta;
+	     sta = sta->next) {
+		if (os_memcmp(sta->addr, after, ETH_ALEN) > 0)
+			stas[num++] = sta;
+	}
+	qsort(stas, num, sizeof(*stas), hostapd_sta_addr_cmp);
+
+	for (i = 0; i < num && i < max; i++) {
+		ret = hostapd_sta_dump_line(hapd, stas[i], attrs, buf + len,
+					    buflen - next_len - len);
+		if (ret < 0)
+			break;
+		len += ret;
+	}
+
+	if (i < num) {
+		if (i == 0) {
+			/* Not even one station fits into the response */
+			os_free(stas);
+			return -1;
+		}
+		ret = os_snprintf(buf + len, buflen - len, "next=" MACSTR "\n",
+				  MAC2STR(stas[i - 1]->addr));
+		if (!os_snprintf_error(buflen - len, ret))
+			len += ret;
+	}
+
+	os_free(stas);
+	return len;
+}
+
+
 #ifdef CONFIG_P2P_MANAGER
 static int p2p_manager_disconnect(struct hostapd_data *hapd, u16 stype,
 				  u8 minor_reason_code, const u8 *addr)
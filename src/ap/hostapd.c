@@ -167,34 +167,38 @@ static void hostapd_reload_bss(struct hostapd_data *hapd)
 }
 
 
-static void hostapd_clear_old(struct hostapd_iface *iface)
+static void hostapd_clear_old_bss(struct hostapd_data *hapd)
 {
-	size_t j;
-
 	/*
 	 * Deauthenticate all stations since the new configuration may not
 	 * allow them to use the BSS anymore.
 	 */
-	for (j = 0; j < iface->num_bss; j++) {
 #ifndef CONFIG_SONIC_HOSTAPD
-		hostapd_flush_old_stations(iface->bss[j],
-					   WLAN_REASON_PREV_AUTH_NOT_VALID);
+	hostapd_flush_old_stations(hapd, WLAN_REASON_PREV_AUTH_NOT_VALID);
 #endif
 #ifdef CONFIG_WEP
-		hostapd_broadcast_wep_clear(iface->bss[j]);
+	hostapd_broadcast_wep_clear(hapd);
 #endif /* CONFIG_WEP */
 
 #ifndef CONFIG_NO_RADIUS
-		/* TODO: update dynamic data based on changed configuration
-		 * items (e.g., open/close sockets, etc.) */
-		radius_client_flush(iface->bss[j]->radius, 0);
+	/* TODO: update dynamic data based on changed configuration
+	 * items (e.g., open/close sockets, etc.) */
+	radius_client_flush(hapd->radius, 0);
 #ifdef CONFIG_SONIC_HOSTAPD
-		radius_close_auth_sockets(iface->bss[j]->radius);
-		radius_close_acct_sockets(iface->bss[j]->radius);
+	radius_close_auth_sockets(hapd->radius);
+	radius_close_acct_sockets(hapd->radius);
 #endif
 
 #endif /* CONFIG_NO_RADIUS */
-	}
+}
+
+
+static void hostapd_clear_old(struct hostapd_iface *iface)
+{
+	size_t j;
+
+	for (j = 0; j < iface->num_bss; j++)
+		hostapd_clear_old_bss(iface->bss[j]);
 }
 
 
@@ -221,7 +225,9 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 	struct hapd_interfaces *interfaces = iface->interfaces;
 	struct hostapd_data *hapd = iface->bss[0];
 	struct hostapd_config *newconf, *oldconf;
-	size_t j;
+	char changes[200];
+	int *changed;
+	size_t j, unchanged = 0;
 
 	if (iface->config_fname == NULL) {
 		/* Only in-memory config in use - assume it has been updated */
@@ -238,13 +244,12 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 	if (newconf == NULL)
 		return -1;
 
-	hostapd_clear_old(iface);
-
 	oldconf = hapd->iconf;
 	if (hostapd_iface_conf_changed(newconf, oldconf)) {
 		char *fname;
 		int res;
 
+		hostapd_clear_old(iface);
 		wpa_printf(MSG_DEBUG,
 			   "Configuration changes include interface/BSS modification - force full disable+enable sequence");
 		fname = os_strdup(iface->config_fname);
@@ -270,6 +275,43 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 				   "Failed to enable interface on config reload");
 		return res;
 	}
+	/*
+	 * Compare each BSS against the configuration it is currently using.
+	 * A BSS whose configuration file section did not change keeps its old
+	 * configuration data (which the RADIUS client, authenticator, and
+	 * station state may reference) and is not reconfigured at all.
+	 */
+	changed = os_calloc(iface->num_bss, sizeof(int));
+	if (!changed) {
+		hostapd_config_free(newconf);
+		return -1;
+	}
+	for (j = 0; j < iface->num_bss; j++) {
+		struct hostapd_bss_config *tmp;
+
+		changed[j] = hostapd_config_bss_diff(oldconf->bss[j],
+						     newconf->bss[j],
+						     changes, sizeof(changes));
+		if (changed[j] == 0) {
+			tmp = newconf->bss[j];
+			newconf->bss[j] = oldconf->bss[j];
+			oldconf->bss[j] = tmp;
+			if (newconf->last_bss == tmp)
+				newconf->last_bss = newconf->bss[j];
+			unchanged++;
+			continue;
+		}
+
+		hapd = iface->bss[j];
+		if (changed[j] < 0)
+			os_strlcpy(changes, "*", sizeof(changes));
+		wpa_printf(MSG_INFO, "%s: Configuration changed: %s",
+			   hapd->conf->iface, changes);
+		wpa_msg(hapd->msg_ctx, MSG_INFO, AP_EVENT_BSS_RELOADED
+			"changed=%s", changes);
+		hostapd_clear_old_bss(hapd);
+	}
+
 	iface->conf = newconf;
 
 	for (j = 0; j < iface->num_bss; j++) {
@@ -291,16 +333,65 @@ int hostapd_reload_config(struct hostapd_iface *iface)
 			hapd->iconf,
 			hostapd_get_oper_centr_freq_seg1_idx(oldconf));
 		hapd->conf = newconf->bss[j];
-		hostapd_reload_bss(hapd);
+		if (changed[j])
+			hostapd_reload_bss(hapd);
+		else if (changed[0] && hapd->started)
+			ieee802_11_set_beacon(hapd);
 	}
+	wpa_printf(MSG_DEBUG,
+		   "Configuration reload left %u of %u BSS(s) unchanged",
+		   (unsigned int) unchanged, (unsigned int) iface->num_bss);
 
+	os_free(changed);
 	hostapd_config_free(oldconf);
 
+	if (iface->interfaces)
+		hostapd_logger_update_modules(iface->interfaces);
 
 	return 0;
 }
 
 
+/**
+ * hostapd_logger_update_modules - Limit hostapd_logger() to configured output
+ * @interfaces: Pointer to interfaces
+ *
+ * hostapd_logger() messages are formatted only for the modules and levels that
+ * at least one BSS has enabled for stdout or syslog (logger_stdout/
+ * logger_syslog with the matching *_level).
+ */
+void hostapd_logger_update_modules(struct hapd_interfaces *interfaces)
+{
+	unsigned int modules[HOSTAPD_LEVEL_WARNING + 1];
+	struct hostapd_bss_config *bss;
+	size_t i, j;
+	int level;
+
+	if (!interfaces->count) {
+		hostapd_logger_set_modules(NULL);
+		return;
+	}
+
+	os_memset(modules, 0, sizeof(modules));
+	for (i = 0; i < interfaces->count; i++) {
+		if (!interfaces->iface[i]->conf)
+			continue;
+		for (j = 0; j < interfaces->iface[i]->conf->num_bss; j++) {
+			bss = interfaces->iface[i]->conf->bss[j];
+			for (level = HOSTAPD_LEVEL_DEBUG_VERBOSE;
+			     level <= HOSTAPD_LEVEL_WARNING; level++) {
+				if (level >= bss->logger_stdout_level)
+					modules[level] |= bss->logger_stdout;
+				if (level >= bss->logger_syslog_level)
+					modules[level] |= bss->logger_syslog;
+			}
+		}
+	}
+
+	hostapd_logger_set_modules(modules);
+}
+
+
 #ifdef CONFIG_WEP
 
 static void hostapd_broadcast_key_clear_iface(struct hostapd_data *hapd,
@@ -363,6 +454,10 @@ static int hostapd_broadcast_wep_set(struct hostapd_data *hapd)
 
 static void hostapd_free_hapd_data(struct hostapd_data *hapd)
 {
+	bin_clear_free(hapd->psk_hints,
+		       STA_HASH_SIZE * sizeof(struct hostapd_psk_hint));
+	hapd->psk_hints = NULL;
+
 	os_free(hapd->probereq_cb);
 	hapd->probereq_cb = NULL;
 	hapd->num_probereq_cb = 0;
@@ -460,6 +555,7 @@ static void hostapd_free_hapd_data(struct hostapd_data *hapd)
 			dl_list_del(&q->list);
 			os_free(q);
 		}
+		hapd->sae_commit_queue_len = 0;
 	}
 	eloop_cancel_timeout(auth_sae_process_commit, hapd, NULL);
 #endif /* CONFIG_SAE */
@@ -791,159 +887,78 @@ static int hostapd_das_nas_mismatch(struct hostapd_data *hapd,
 }
 
 
-static struct sta_info * hostapd_das_find_sta(struct hostapd_data *hapd,
-					      struct radius_das_attrs *attr,
-					      int *multi)
+static int hostapd_das_parse_session_id(const u8 *id, size_t id_len,
+					u64 *val)
 {
-	struct sta_info *selected, *sta;
-	char buf[128];
-	int num_attr = 0;
-	int count;
-
-	*multi = 0;
-
-	for (sta = hapd->sta_list; sta; sta = sta->next)
-		sta->radius_das_match = 1;
-
-	if (attr->sta_addr) {
-		num_attr++;
-		sta = ap_get_sta(hapd, attr->sta_addr);
-		if (!sta) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: No Calling-Station-Id match");
-			return NULL;
-		}
+	size_t i;
 
-		selected = sta;
-		for (sta = hapd->sta_list; sta; sta = sta->next) {
-			if (sta != selected)
-				sta->radius_das_match = 0;
-		}
-		wpa_printf(MSG_DEBUG, "RADIUS DAS: Calling-Station-Id match");
+	/* Session ids are encoded with "%016llX" */
+	if (id_len != 16)
+		return -1;
+	*val = 0;
+	for (i = 0; i < id_len; i++) {
+		if (id[i] >= '0' && id[i] <= '9')
+			*val = (*val << 4) | (id[i] - '0');
+		else if (id[i] >= 'A' && id[i] <= 'F')
+			*val = (*val << 4) | (id[i] - 'A' + 10);
+		else
+			return -1;
 	}
 
-	if (attr->acct_session_id) {
-		num_attr++;
-		if (attr->acct_session_id_len != 16) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: Acct-Session-Id cannot match");
-			return NULL;
-		}
-		count = 0;
-
-		for (sta = hapd->sta_list; sta; sta = sta->next) {
-			if (!sta->radius_das_match)
-				continue;
-			os_snprintf(buf, sizeof(buf), "%016llX",
-				    (unsigned long long) sta->acct_session_id);
-			if (os_memcmp(attr->acct_session_id, buf, 16) != 0)
-				sta->radius_das_match = 0;
-			else
-				count++;
-		}
-
-		if (count == 0) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: No matches remaining after Acct-Session-Id check");
-			return NULL;
-		}
-		wpa_printf(MSG_DEBUG, "RADIUS DAS: Acct-Session-Id match");
-	}
+	return 0;
+}
 
-	if (attr->acct_multi_session_id) {
-		num_attr++;
-		if (attr->acct_multi_session_id_len != 16) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: Acct-Multi-Session-Id cannot match");
-			return NULL;
-		}
-		count = 0;
 
-		for (sta = hapd->sta_list; sta; sta = sta->next) {
-			if (!sta->radius_das_match)
-				continue;
-			if (!sta->eapol_sm ||
-			    !sta->eapol_sm->acct_multi_session_id) {
-				sta->radius_das_match = 0;
-				continue;
-			}
-			os_snprintf(buf, sizeof(buf), "%016llX",
-				    (unsigned long long)
-				    sta->eapol_sm->acct_multi_session_id);
-			if (os_memcmp(attr->acct_multi_session_id, buf, 16) !=
-			    0)
-				sta->radius_das_match = 0;
-			else
-				count++;
-		}
+static int hostapd_das_sta_match(struct sta_info *sta,
+				 struct radius_das_attrs *attr,
+				 u64 session_id, u64 multi_session_id)
+{
+	if (attr->acct_session_id && sta->acct_session_id != session_id)
+		return 0;
 
-		if (count == 0) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: No matches remaining after Acct-Multi-Session-Id check");
-			return NULL;
-		}
-		wpa_printf(MSG_DEBUG,
-			   "RADIUS DAS: Acct-Multi-Session-Id match");
-	}
+	if (attr->acct_multi_session_id &&
+	    (!sta->eapol_sm ||
+	     !sta->eapol_sm->acct_multi_session_id ||
+	     sta->eapol_sm->acct_multi_session_id != multi_session_id))
+		return 0;
 
 	if (attr->cui) {
-		num_attr++;
-		count = 0;
-
-		for (sta = hapd->sta_list; sta; sta = sta->next) {
-			struct wpabuf *cui;
+		struct wpabuf *cui;
 
-			if (!sta->radius_das_match)
-				continue;
-			cui = ieee802_1x_get_radius_cui(sta->eapol_sm);
-			if (!cui || wpabuf_len(cui) != attr->cui_len ||
-			    os_memcmp(wpabuf_head(cui), attr->cui,
-				      attr->cui_len) != 0)
-				sta->radius_das_match = 0;
-			else
-				count++;
-		}
-
-		if (count == 0) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: No matches remaining after Chargeable-User-Identity check");
-			return NULL;
-		}
-		wpa_printf(MSG_DEBUG,
-			   "RADIUS DAS: Chargeable-User-Identity match");
+		cui = ieee802_1x_get_radius_cui(sta->eapol_sm);
+		if (!cui || wpabuf_len(cui) != attr->cui_len ||
+		    os_memcmp(wpabuf_head(cui), attr->cui,
+			      attr->cui_len) != 0)
+			return 0;
 	}
 
 	if (attr->user_name) {
-		num_attr++;
-		count = 0;
+		u8 *identity;
+		size_t identity_len;
+
+		identity = ieee802_1x_get_identity(sta->eapol_sm,
+						   &identity_len);
+		if (!identity ||
+		    identity_len != attr->user_name_len ||
+		    os_memcmp(identity, attr->user_name, identity_len) != 0)
+			return 0;
+	}
 
-		for (sta = hapd->sta_list; sta; sta = sta->next) {
-			u8 *identity;
-			size_t identity_len;
+	return 1;
+}
 
-			if (!sta->radius_das_match)
-				continue;
-			identity = ieee802_1x_get_identity(sta->eapol_sm,
-							   &identity_len);
-			if (!identity ||
-			    identity_len != attr->user_name_len ||
-			    os_memcmp(identity, attr->user_name, identity_len)
-			    != 0)
-				sta->radius_das_match = 0;
-			else
-				count++;
-		}
-
-		if (count == 0) {
-			wpa_printf(MSG_DEBUG,
-				   "RADIUS DAS: No matches remaining after User-Name check");
-			return NULL;
-		}
-		wpa_printf(MSG_DEBUG,
-			   "RADIUS DAS: User-Name match");
-	}
 
-	if (num_attr == 0) {
+static struct sta_info * hostapd_das_find_sta(struct hostapd_data *hapd,
+					      struct radius_das_attrs *attr,
+					      int *multi)
+{
+	struct sta_info *selected, *sta;
+	u64 session_id = 0, multi_session_id = 0;
+
+	*multi = 0;
+
+	if (!attr->sta_addr && !attr->acct_session_id &&
+	    !attr->acct_multi_session_id && !attr->cui && !attr->user_name) {
 		/*
 		 * In theory, we could match all current associations, but it
 		 * seems safer to just reject requests that do not include any
@@ -954,9 +969,59 @@ static struct sta_info * hostapd_das_find_sta(struct hostapd_data *hapd,
 		return NULL;
 	}
 
+	if (attr->acct_session_id &&
+	    hostapd_das_parse_session_id(attr->acct_session_id,
+					 attr->acct_session_id_len,
+					 &session_id) < 0) {
+		wpa_printf(MSG_DEBUG,
+			   "RADIUS DAS: Acct-Session-Id cannot match");
+		return NULL;
+	}
+
+	if (attr->acct_multi_session_id &&
+	    hostapd_das_parse_session_id(attr->acct_multi_session_id,
+					 attr->acct_multi_session_id_len,
+					 &multi_session_id) < 0) {
+		wpa_printf(MSG_DEBUG,
+			   "RADIUS DAS: Acct-Multi-Session-Id cannot match");
+		return NULL;
+	}
+
+	if (attr->sta_addr) {
+		sta = ap_get_sta(hapd, attr->sta_addr);
+		if (!sta) {
+			wpa_printf(MSG_DEBUG,
+				   "RADIUS DAS: No Calling-Station-Id match");
+			return NULL;
+		}
+		if (!hostapd_das_sta_match(sta, attr, session_id,
+					   multi_session_id)) {
+			wpa_printf(MSG_DEBUG,
+				   "RADIUS DAS: Session attributes do not match the Calling-Station-Id entry");
+			return NULL;
+		}
+		return sta;
+	}
+
 	selected = NULL;
-	for (sta = hapd->sta_list; sta; sta = sta->next) {
-		if (sta->radius_das_match) {
+	if (attr->acct_session_id) {
+		/* Use the session index instead of going through all STAs */
+		for (sta = ap_get_sta_session(hapd, session_id, NULL); sta;
+		     sta = ap_get_sta_session(hapd, session_id, sta)) {
+			if (!hostapd_das_sta_match(sta, attr, session_id,
+						   multi_session_id))
+				continue;
+			if (selected) {
+				*multi = 1;
+				return NULL;
+			}
+			selected = sta;
+		}
+	} else {
+		for (sta = hapd->sta_list; sta; sta = sta->next) {
+			if (!hostapd_das_sta_match(sta, attr, session_id,
+						   multi_session_id))
+				continue;
 			if (selected) {
 				*multi = 1;
 				return NULL;
@@ -965,6 +1030,10 @@ static struct sta_info * hostapd_das_find_sta(struct hostapd_data *hapd,
 		}
 	}
 
+	if (!selected)
+		wpa_printf(MSG_DEBUG,
+			   "RADIUS DAS: No session matches all attributes");
+
 	return selected;
 }
 
@@ -2165,6 +2234,8 @@ dfs_offload:
 
 	wpa_printf(MSG_DEBUG, "%s: Setup of interface done.",
 		   iface->bss[0]->conf->iface);
+	if (iface->interfaces)
+		hostapd_logger_update_modules(iface->interfaces);
 	if (iface->interfaces && iface->interfaces->terminate_on_error > 0)
 		iface->interfaces->terminate_on_error--;
 
@@ -15,6 +15,9 @@
 
 #include "common/defs.h"
 #include "utils/list.h"
+#ifdef CONFIG_LATENCY_STATS
+#include "utils/latency_hist.h"
+#endif /* CONFIG_LATENCY_STATS */
 #include "ap_config.h"
 #include "drivers/driver.h"
 
@@ -77,6 +80,8 @@ struct hapd_interfaces {
 	struct dpp_global *dpp;
 #endif /* CONFIG_DPP */
 
+	struct ctrl_iface_cmd_stats *ctrl_stats;
+
 #ifdef CONFIG_CTRL_IFACE_UDP
        unsigned char ctrl_iface_cookie[CTRL_IFACE_COOKIE_LEN];
 #endif /* CONFIG_CTRL_IFACE_UDP */
@@ -143,6 +148,7 @@ struct hostapd_neighbor_entry {
 struct hostapd_sae_commit_queue {
 	struct dl_list list;
 	int rssi;
+	struct os_reltime queued; /* time when the frame was queued */
 	size_t len;
 	u8 msg[];
 };
@@ -166,6 +172,9 @@ struct hostapd_data {
 #define STA_HASH_SIZE 256
 #define STA_HASH(sta) (sta[5])
 	struct sta_info *sta_hash[STA_HASH_SIZE];
+#define STA_SESSION_HASH(id) ((id) & (STA_HASH_SIZE - 1))
+	/* STAs indexed by acct_session_id for RADIUS DAS lookups */
+	struct sta_info *sta_session_hash[STA_HASH_SIZE];
 
 	/*
 	 * Bitfield for indicating which AIDs are allocated. Only AID values
@@ -195,6 +204,26 @@ struct hostapd_data {
 	struct eapol_authenticator *eapol_auth;
 	struct eap_config *eap_cfg;
 
+#ifdef CONFIG_LATENCY_STATS
+	/* EAPOL frame received -> RADIUS Access-Request sent */
+	struct latency_hist eapol_radius_hist;
+	/* EAP server state machine step that changed state */
+	struct latency_hist eap_step_hist;
+	/* First EAPOL frame -> IEEE 802.1X authentication succeeded */
+	struct latency_hist auth_complete_hist;
+#endif /* CONFIG_LATENCY_STATS */
+
+	/*
+	 * Last PSK that matched in the 4-way handshake for a STA when more
+	 * than one PSK is configured; direct-mapped by STA_HASH(). This is
+	 * tried first on the next association to avoid PTK derivation and MIC
+	 * trials over the full wpa_psk_file list.
+	 */
+	struct hostapd_psk_hint {
+		u8 addr[ETH_ALEN];
+		u8 psk[PMK_LEN];
+	} *psk_hints;
+
 	struct rsn_preauth_interface *preauth_iface;
 	struct os_reltime michael_mic_failure;
 	int michael_mic_failures;
@@ -332,6 +361,16 @@ struct hostapd_data {
 	u16 sae_pending_token_idx[256];
 	int dot11RSNASAERetransPeriod; /* msec */
 	struct dl_list sae_commit_queue; /* struct hostapd_sae_commit_queue */
+	unsigned int sae_commit_queue_len; /* number of sae_commit_queue entries */
+	/* SAE commit queue statistics for the MIB command */
+	unsigned int sae_commit_queue_max_len;
+	unsigned int sae_commit_queue_dropped;
+	unsigned int sae_commit_processed;
+	u64 sae_commit_wait_total; /* usec */
+	unsigned int sae_commit_wait_max; /* usec */
+#define SAE_COMMIT_WAIT_HIST_SIZE 5
+	/* Queue wait time histogram: <10, <50, <100, <500, >=500 ms */
+	unsigned int sae_commit_wait_hist[SAE_COMMIT_WAIT_HIST_SIZE];
 #endif /* CONFIG_SAE */
 
 #ifdef CONFIG_TESTING_OPTIONS
@@ -596,6 +635,7 @@ int hostapd_for_each_interface(struct hapd_interfaces *interfaces,
 			       int (*cb)(struct hostapd_iface *iface,
 					 void *ctx), void *ctx);
 int hostapd_reload_config(struct hostapd_iface *iface);
+void hostapd_logger_update_modules(struct hapd_interfaces *interfaces);
 void hostapd_reconfig_encryption(struct hostapd_data *hapd);
 struct hostapd_data *
 hostapd_alloc_bss_data(struct hostapd_iface *hapd_iface,
@@ -667,7 +667,7 @@ static int use_sae_anti_clogging(struct hostapd_data *hapd)
 	/* In addition to already existing open SAE sessions, check whether
 	 * there are enough pending commit messages in the processing queue to
 	 * potentially result in too many open sessions. */
-	if (open + dl_list_len(&hapd->sae_commit_queue) >=
+	if (open + hapd->sae_commit_queue_len >=
 	    hapd->conf->sae_anti_clogging_threshold)
 		return 1;
 
@@ -1561,11 +1561,42 @@ int auth_sae_init_committed(struct hostapd_data *hapd, struct sta_info *sta)
 }
 
 
+static void auth_sae_queue_wait_stats(struct hostapd_data *hapd,
+				      struct hostapd_sae_commit_queue *q)
+{
+	struct os_reltime now, age;
+	unsigned int wait, idx;
+
+	os_get_reltime(&now);
+	os_reltime_sub(&now, &q->queued, &age);
+	if (age.sec >= 1000)
+		wait = 1000000000;
+	else
+		wait = age.sec * 1000000 + age.usec;
+
+	hapd->sae_commit_processed++;
+	hapd->sae_commit_wait_total += wait;
+	if (wait > hapd->sae_commit_wait_max)
+		hapd->sae_commit_wait_max = wait;
+
+	if (wait < 10000)
+		idx = 0;
+	else if (wait < 50000)
+		idx = 1;
+	else if (wait < 100000)
+		idx = 2;
+	else if (wait < 500000)
+		idx = 3;
+	else
+		idx = 4;
+	hapd->sae_commit_wait_hist[idx]++;
+}
+
+
 void auth_sae_process_commit(void *eloop_ctx, void *user_ctx)
 {
 	struct hostapd_data *hapd = eloop_ctx;
 	struct hostapd_sae_commit_queue *q;
-	unsigned int queue_len;
 
 	q = dl_list_first(&hapd->sae_commit_queue,
 			  struct hostapd_sae_commit_queue, list);
@@ -1574,15 +1605,16 @@ void auth_sae_process_commit(void *eloop_ctx, void *user_ctx)
 	wpa_printf(MSG_DEBUG,
 		   "SAE: Process next available message from queue");
 	dl_list_del(&q->list);
+	hapd->sae_commit_queue_len--;
+	auth_sae_queue_wait_stats(hapd, q);
 	handle_auth(hapd, (const struct ieee80211_mgmt *) q->msg, q->len,
 		    q->rssi, 1);
 	os_free(q);
 
 	if (eloop_is_timeout_registered(auth_sae_process_commit, hapd, NULL))
 		return;
-	queue_len = dl_list_len(&hapd->sae_commit_queue);
-	eloop_register_timeout(0, queue_len * 10000, auth_sae_process_commit,
-			       hapd, NULL);
+	eloop_register_timeout(0, hapd->sae_commit_queue_len * 10000,
+			       auth_sae_process_commit, hapd, NULL);
 }
 
 
@@ -1594,11 +1626,12 @@ static void auth_sae_queue(struct hostapd_data *hapd,
 	unsigned int queue_len;
 	const struct ieee80211_mgmt *mgmt2;
 
-	queue_len = dl_list_len(&hapd->sae_commit_queue);
+	queue_len = hapd->sae_commit_queue_len;
 	if (queue_len >= 15) {
 		wpa_printf(MSG_DEBUG,
 			   "SAE: No more room in message queue - drop the new frame from "
 			   MACSTR, MAC2STR(mgmt->sa));
+		hapd->sae_commit_queue_dropped++;
 		return;
 	}
 
@@ -1609,6 +1642,7 @@ static void auth_sae_queue(struct hostapd_data *hapd,
 	if (!q)
 		return;
 	q->rssi = rssi;
+	os_get_reltime(&q->queued);
 	q->len = len;
 	os_memcpy(q->msg, mgmt, len);
 
@@ -1635,6 +1669,9 @@ static void auth_sae_queue(struct hostapd_data *hapd,
 
 	/* No pending identical entry, so add to the end of the queue */
 	dl_list_add_tail(&hapd->sae_commit_queue, &q->list);
+	hapd->sae_commit_queue_len++;
+	if (hapd->sae_commit_queue_len > hapd->sae_commit_queue_max_len)
+		hapd->sae_commit_queue_max_len = hapd->sae_commit_queue_len;
 
 queued:
 	if (eloop_is_timeout_registered(auth_sae_process_commit, hapd, NULL))
@@ -5423,8 +5460,36 @@ void ieee802_11_mgmt_cb(struct hostapd_data *hapd, const u8 *buf, size_t len,
 
 int ieee802_11_get_mib(struct hostapd_data *hapd, char *buf, size_t buflen)
 {
-	/* TODO */
+#ifdef CONFIG_SAE
+	int ret;
+
+	ret = os_snprintf(buf, buflen,
+			  "sae_commit_queue_len=%u\n"
+			  "sae_commit_queue_max_len=%u\n"
+			  "sae_commit_queue_dropped=%u\n"
+			  "sae_commit_processed=%u\n"
+			  "sae_commit_wait_avg_usec=%llu\n"
+			  "sae_commit_wait_max_usec=%u\n"
+			  "sae_commit_wait_hist=%u,%u,%u,%u,%u\n",
+			  hapd->sae_commit_queue_len,
+			  hapd->sae_commit_queue_max_len,
+			  hapd->sae_commit_queue_dropped,
+			  hapd->sae_commit_processed,
+			  hapd->sae_commit_processed ?
+			  (unsigned long long) (hapd->sae_commit_wait_total /
+						hapd->sae_commit_processed) : 0,
+			  hapd->sae_commit_wait_max,
+			  hapd->sae_commit_wait_hist[0],
+			  hapd->sae_commit_wait_hist[1],
+			  hapd->sae_commit_wait_hist[2],
+			  hapd->sae_commit_wait_hist[3],
+			  hapd->sae_commit_wait_hist[4]);
+	if (os_snprintf_error(buflen, ret))
+		return 0;
+	return ret;
+#else /* CONFIG_SAE */
 	return 0;
+#endif /* CONFIG_SAE */
 }
 
 
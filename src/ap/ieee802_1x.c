@@ -1170,6 +1170,15 @@ void ieee802_1x_receive(struct hostapd_data *hapd, const u8 *sa, const u8 *buf,
 	 * more or less identically. Some changes might be needed for
 	 * verification of fields. */
 
+#ifdef CONFIG_LATENCY_STATS
+	if (hdr->type == IEEE802_1X_TYPE_EAP_PACKET ||
+	    hdr->type == IEEE802_1X_TYPE_EAPOL_START) {
+		os_get_reltime(&sta->eapol_rx_time);
+		if (!sta->auth_start.sec)
+			sta->auth_start = sta->eapol_rx_time;
+	}
+#endif /* CONFIG_LATENCY_STATS */
+
 	switch (hdr->type) {
 	case IEEE802_1X_TYPE_EAP_PACKET:
 		handle_eap(hapd, sta, (u8 *) (hdr + 1), datalen);
@@ -2291,6 +2300,13 @@ static void ieee802_1x_aaa_send(void *ctx, void *sta_ctx,
 	struct sta_info *sta = sta_ctx;
 
 	ieee802_1x_encapsulate_radius(hapd, sta, data, datalen);
+#ifdef CONFIG_LATENCY_STATS
+	if (sta->eapol_rx_time.sec) {
+		latency_hist_add_since(&hapd->eapol_radius_hist,
+				       &sta->eapol_rx_time);
+		sta->eapol_rx_time.sec = 0;
+	}
+#endif /* CONFIG_LATENCY_STATS */
 #endif /* CONFIG_NO_RADIUS */
 }
 
@@ -2486,6 +2502,9 @@ int ieee802_1x_init(struct hostapd_data *hapd)
 	conf.eap_cfg = hapd->eap_cfg;
 	conf.ctx = hapd;
 	conf.eap_reauth_period = hapd->conf->eap_reauth_period;
+#ifdef CONFIG_LATENCY_STATS
+	conf.eap_step_hist = &hapd->eap_step_hist;
+#endif /* CONFIG_LATENCY_STATS */
 	conf.wpa = hapd->conf->wpa;
 #ifdef CONFIG_WEP
 	conf.individual_wep_key_len = hapd->conf->individual_wep_key_len;
@@ -3057,4 +3076,13 @@ static void ieee802_1x_finished(struct hostapd_data *hapd,
     hostapd_drv_auth_resp_send(hapd, hapd->conf->iface, sta->addr, "auth_success", (void *) sta);
  }
 #endif
+
+#ifdef CONFIG_LATENCY_STATS
+	if (sta->auth_start.sec) {
+		if (success)
+			latency_hist_add_since(&hapd->auth_complete_hist,
+					       &sta->auth_start);
+		sta->auth_start.sec = 0;
+	}
+#endif /* CONFIG_LATENCY_STATS */
 }
@@ -77,6 +77,29 @@ struct sta_info * ap_get_sta(struct hostapd_data *hapd, const u8 *sta)
 }
 
 
+/**
+ * ap_get_sta_session - Find STAs based on Acct-Session-Id
+ * @hapd: Pointer to BSS data
+ * @acct_session_id: Accounting session identifier
+ * @prev: Previously returned STA or %NULL to start from the beginning
+ * Returns: The next STA using acct_session_id or %NULL if no more entries
+ */
+struct sta_info * ap_get_sta_session(struct hostapd_data *hapd,
+				     u64 acct_session_id,
+				     struct sta_info *prev)
+{
+	struct sta_info *s;
+
+	if (prev)
+		s = prev->session_hnext;
+	else
+		s = hapd->sta_session_hash[STA_SESSION_HASH(acct_session_id)];
+	while (s && s->acct_session_id != acct_session_id)
+		s = s->session_hnext;
+	return s;
+}
+
+
 #ifdef CONFIG_P2P
 struct sta_info * ap_get_sta_p2p(struct hostapd_data *hapd, const u8 *addr)
 {
@@ -150,6 +173,32 @@ static void ap_sta_hash_del(struct hostapd_data *hapd, struct sta_info *sta)
 }
 
 
+static void ap_sta_session_hash_add(struct hostapd_data *hapd,
+				    struct sta_info *sta)
+{
+	unsigned int idx = STA_SESSION_HASH(sta->acct_session_id);
+
+	sta->session_hnext = hapd->sta_session_hash[idx];
+	hapd->sta_session_hash[idx] = sta;
+}
+
+
+static void ap_sta_session_hash_del(struct hostapd_data *hapd,
+				    struct sta_info *sta)
+{
+	struct sta_info **s;
+
+	s = &hapd->sta_session_hash[STA_SESSION_HASH(sta->acct_session_id)];
+	while (*s && *s != sta)
+		s = &(*s)->session_hnext;
+	if (*s)
+		*s = sta->session_hnext;
+	else
+		wpa_printf(MSG_DEBUG, "AP: could not remove STA " MACSTR
+			   " from session hash table", MAC2STR(sta->addr));
+}
+
+
 void ap_sta_ip6addr_del(struct hostapd_data *hapd, struct sta_info *sta)
 {
 	sta_ip6addr_del(hapd, sta);
@@ -180,6 +229,7 @@ void ap_free_sta(struct hostapd_data *hapd, struct sta_info *sta)
 	}
 
 	ap_sta_hash_del(hapd, sta);
+	ap_sta_session_hash_del(hapd, sta);
 	ap_sta_list_del(hapd, sta);
 
 	if (sta->aid > 0)
@@ -722,6 +772,7 @@ struct sta_info * ap_sta_add(struct hostapd_data *hapd, const u8 *addr)
 	hapd->sta_list = sta;
 	hapd->num_sta++;
 	ap_sta_hash_add(hapd, sta);
+	ap_sta_session_hash_add(hapd, sta);
 	ap_sta_remove_in_other_bss(hapd, sta);
 	sta->last_seq_ctrl = WLAN_INVALID_MGMT_SEQ;
 	dl_list_init(&sta->ip6addr);
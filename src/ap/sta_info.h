@@ -69,6 +69,7 @@ struct pending_eapol_rx {
 struct sta_info {
 	struct sta_info *next; /* next entry in sta list */
 	struct sta_info *hnext; /* next entry in hash table list */
+	struct sta_info *session_hnext; /* next entry in session hash list */
 	u8 addr[6];
 	be32 ipaddr;
 	struct dl_list ip6addr; /* list head for struct ip6addr */
@@ -116,7 +117,6 @@ struct sta_info {
 	unsigned int remediation:1;
 	unsigned int hs20_deauth_requested:1;
 	unsigned int session_timeout_set:1;
-	unsigned int radius_das_match:1;
 	unsigned int ecsa_supported:1;
 	unsigned int added_unassoc:1;
 	unsigned int pending_wds_enable:1;
@@ -141,6 +141,10 @@ struct sta_info {
 	struct eapol_state_machine *eapol_sm;
 
 	struct pending_eapol_rx *pending_eapol_rx;
+#ifdef CONFIG_LATENCY_STATS
+	struct os_reltime eapol_rx_time; /* last EAPOL frame, until forwarded */
+	struct os_reltime auth_start; /* first EAPOL frame of authentication */
+#endif /* CONFIG_LATENCY_STATS */
 
 	u64 acct_session_id;
 	struct os_reltime acct_session_start;
@@ -317,6 +321,9 @@ int ap_for_each_sta(struct hostapd_data *hapd,
 		    void *ctx);
 struct sta_info * ap_get_sta(struct hostapd_data *hapd, const u8 *sta);
 struct sta_info * ap_get_sta_p2p(struct hostapd_data *hapd, const u8 *addr);
+struct sta_info * ap_get_sta_session(struct hostapd_data *hapd,
+				     u64 acct_session_id,
+				     struct sta_info *prev);
 void ap_sta_hash_add(struct hostapd_data *hapd, struct sta_info *sta);
 void ap_free_sta(struct hostapd_data *hapd, struct sta_info *sta);
 void ap_sta_ip6addr_del(struct hostapd_data *hapd, struct sta_info *sta);
@@ -96,6 +96,16 @@ static inline void wpa_auth_psk_failure_report(
 }
 
 
+static inline void wpa_auth_psk_success_report(
+	struct wpa_authenticator *wpa_auth, const u8 *addr, const u8 *psk,
+	size_t psk_len)
+{
+	if (wpa_auth->cb->psk_success_report)
+		wpa_auth->cb->psk_success_report(wpa_auth->cb_ctx, addr, psk,
+						 psk_len);
+}
+
+
 static inline void wpa_auth_set_eapol(struct wpa_authenticator *wpa_auth,
 				      const u8 *addr, wpa_eapol_variable var,
 				      int value)
@@ -2970,6 +2980,9 @@ SM_STATE(WPA_PTK, PTKCALCNEGOTIATING)
 			wpa_auth_psk_failure_report(sm->wpa_auth, sm->addr);
 		return;
 	}
+	if (psk_found)
+		wpa_auth_psk_success_report(sm->wpa_auth, sm->addr, pmk,
+					    pmk_len);
 
 	/*
 	 * Note: last_rx_eapol_key length fields have already been validated in
@@ -4551,6 +4564,10 @@ int wpa_get_mib(struct wpa_authenticator *wpa_auth, char *buf, size_t buflen)
 		return len;
 	len += ret;
 
+#ifdef CONFIG_IEEE80211R_AP
+	len += wpa_ft_get_mib(wpa_auth, buf + len, buflen - len);
+#endif /* CONFIG_IEEE80211R_AP */
+
 	return len;
 }
 
@@ -164,6 +164,9 @@ struct ft_remote_r1kh {
 	u8 id[FT_R1KH_ID_LEN];
 	u8 key[32];
 	struct ft_remote_seq *seq;
+	/* PMK-R1 push statistics */
+	unsigned int push_sent;
+	unsigned int push_failed;
 };
 
 
@@ -280,6 +283,8 @@ struct wpa_auth_callbacks {
 	void (*disconnect)(void *ctx, const u8 *addr, u16 reason);
 	int (*mic_failure_report)(void *ctx, const u8 *addr);
 	void (*psk_failure_report)(void *ctx, const u8 *addr);
+	void (*psk_success_report)(void *ctx, const u8 *addr, const u8 *psk,
+				   size_t psk_len);
 	void (*set_eapol)(void *ctx, const u8 *addr, wpa_eapol_variable var,
 			  int value);
 	int (*get_eapol)(void *ctx, const u8 *addr, wpa_eapol_variable var);
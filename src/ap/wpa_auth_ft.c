@@ -1166,8 +1166,16 @@ static int wpa_ft_new_seq(struct ft_remote_seq *rkh_seq,
 }
 
 
+/* Expiration list entry; the lists are sorted by expiration time */
+struct wpa_ft_pmk_exp {
+	struct dl_list list;
+	os_time_t time; /* 0 if the entry is not on an expiration list */
+};
+
 struct wpa_ft_pmk_r0_sa {
 	struct dl_list list;
+	struct wpa_ft_pmk_r0_sa *hnext; /* next entry in hash table list */
+	struct wpa_ft_pmk_exp exp;
 	u8 pmk_r0[PMK_LEN_MAX];
 	size_t pmk_r0_len;
 	u8 pmk_r0_name[WPA_PMK_NAME_LEN];
@@ -1186,6 +1194,8 @@ struct wpa_ft_pmk_r0_sa {
 
 struct wpa_ft_pmk_r1_sa {
 	struct dl_list list;
+	struct wpa_ft_pmk_r1_sa *hnext; /* next entry in hash table list */
+	struct wpa_ft_pmk_exp exp;
 	u8 pmk_r1[PMK_LEN_MAX];
 	size_t pmk_r1_len;
 	u8 pmk_r1_name[WPA_PMK_NAME_LEN];
@@ -1200,9 +1210,23 @@ struct wpa_ft_pmk_r1_sa {
 	/* TODO: radius_class, EAP type */
 };
 
+/*
+ * Cache entries are indexed by the SPA (and each hash table list is kept in
+ * most recently added first order, like the full lists). Expiration uses
+ * one eloop timeout per list instead of one per entry: entries with a
+ * lifetime are kept on a list sorted by expiration time and the timeout is
+ * set for the first entry on that list.
+ */
+#define FT_PMK_CACHE_HASH_SIZE 256
+#define FT_PMK_CACHE_HASH(spa) ((spa)[5])
+
 struct wpa_ft_pmk_cache {
 	struct dl_list pmk_r0; /* struct wpa_ft_pmk_r0_sa */
 	struct dl_list pmk_r1; /* struct wpa_ft_pmk_r1_sa */
+	struct wpa_ft_pmk_r0_sa *pmk_r0_hash[FT_PMK_CACHE_HASH_SIZE];
+	struct wpa_ft_pmk_r1_sa *pmk_r1_hash[FT_PMK_CACHE_HASH_SIZE];
+	struct dl_list pmk_r0_exp; /* struct wpa_ft_pmk_exp */
+	struct dl_list pmk_r1_exp; /* struct wpa_ft_pmk_exp */
 };
 
 
@@ -1210,13 +1234,67 @@ static void wpa_ft_expire_pmk_r0(void *eloop_ctx, void *timeout_ctx);
 static void wpa_ft_expire_pmk_r1(void *eloop_ctx, void *timeout_ctx);
 
 
-static void wpa_ft_free_pmk_r0(struct wpa_ft_pmk_r0_sa *r0)
+static void wpa_ft_pmk_exp_schedule(struct wpa_ft_pmk_cache *cache,
+				    struct dl_list *exp_list,
+				    eloop_timeout_handler handler)
+{
+	struct wpa_ft_pmk_exp *first;
+	struct os_reltime now;
+
+	eloop_cancel_timeout(handler, cache, NULL);
+	first = dl_list_first(exp_list, struct wpa_ft_pmk_exp, list);
+	if (!first)
+		return;
+	os_get_reltime(&now);
+	eloop_register_timeout(first->time > now.sec ? first->time - now.sec : 0,
+			       0, handler, cache, NULL);
+}
+
+
+static void wpa_ft_pmk_exp_add(struct wpa_ft_pmk_cache *cache,
+			       struct dl_list *exp_list,
+			       eloop_timeout_handler handler,
+			       struct wpa_ft_pmk_exp *exp, os_time_t time)
 {
+	struct wpa_ft_pmk_exp *pos;
+
+	exp->time = time;
+	/* Entries are mostly added in expiration order, so start from the end
+	 */
+	dl_list_for_each_reverse(pos, exp_list, struct wpa_ft_pmk_exp, list) {
+		if (pos->time <= time) {
+			dl_list_add(&pos->list, &exp->list);
+			return;
+		}
+	}
+	dl_list_add(exp_list, &exp->list);
+	wpa_ft_pmk_exp_schedule(cache, exp_list, handler);
+}
+
+
+static void wpa_ft_pmk_exp_del(struct wpa_ft_pmk_exp *exp)
+{
+	if (exp->time)
+		dl_list_del(&exp->list);
+	exp->time = 0;
+}
+
+
+static void wpa_ft_free_pmk_r0(struct wpa_ft_pmk_cache *cache,
+			       struct wpa_ft_pmk_r0_sa *r0)
+{
+	struct wpa_ft_pmk_r0_sa **pos;
+
 	if (!r0)
 		return;
 
+	pos = &cache->pmk_r0_hash[FT_PMK_CACHE_HASH(r0->spa)];
+	while (*pos && *pos != r0)
+		pos = &(*pos)->hnext;
+	if (*pos)
+		*pos = r0->hnext;
 	dl_list_del(&r0->list);
-	eloop_cancel_timeout(wpa_ft_expire_pmk_r0, r0, NULL);
+	wpa_ft_pmk_exp_del(&r0->exp);
 
 	os_memset(r0->pmk_r0, 0, PMK_LEN_MAX);
 	os_free(r0->vlan);
@@ -1228,49 +1306,40 @@ static void wpa_ft_free_pmk_r0(struct wpa_ft_pmk_r0_sa *r0)
 
 static void wpa_ft_expire_pmk_r0(void *eloop_ctx, void *timeout_ctx)
 {
-	struct wpa_ft_pmk_r0_sa *r0 = eloop_ctx;
+	struct wpa_ft_pmk_cache *cache = eloop_ctx;
+	struct wpa_ft_pmk_exp *exp;
 	struct os_reltime now;
-	int expires_in;
-	int session_timeout;
 
 	os_get_reltime(&now);
 
-	if (!r0)
-		return;
+	/* Remove entries whose expiration or session timeout has been hit */
+	while ((exp = dl_list_first(&cache->pmk_r0_exp, struct wpa_ft_pmk_exp,
+				    list)) &&
+	       exp->time <= now.sec)
+		wpa_ft_free_pmk_r0(cache, dl_list_entry(exp,
+							struct wpa_ft_pmk_r0_sa,
+							exp));
 
-	expires_in = r0->expiration - now.sec;
-	session_timeout = r0->session_timeout - now.sec;
-	/* conditions to remove from cache:
-	 * a) r0->expiration is set and hit
-	 * -or-
-	 * b) r0->session_timeout is set and hit
-	 */
-	if ((!r0->expiration || expires_in > 0) &&
-	    (!r0->session_timeout || session_timeout > 0)) {
-		wpa_printf(MSG_ERROR,
-			   "FT: %s() called for non-expired entry %p",
-			   __func__, r0);
-		eloop_cancel_timeout(wpa_ft_expire_pmk_r0, r0, NULL);
-		if (r0->expiration && expires_in > 0)
-			eloop_register_timeout(expires_in + 1, 0,
-					       wpa_ft_expire_pmk_r0, r0, NULL);
-		if (r0->session_timeout && session_timeout > 0)
-			eloop_register_timeout(session_timeout + 1, 0,
-					       wpa_ft_expire_pmk_r0, r0, NULL);
-		return;
-	}
-
-	wpa_ft_free_pmk_r0(r0);
+	wpa_ft_pmk_exp_schedule(cache, &cache->pmk_r0_exp,
+				wpa_ft_expire_pmk_r0);
 }
 
 
-static void wpa_ft_free_pmk_r1(struct wpa_ft_pmk_r1_sa *r1)
+static void wpa_ft_free_pmk_r1(struct wpa_ft_pmk_cache *cache,
+			       struct wpa_ft_pmk_r1_sa *r1)
 {
+	struct wpa_ft_pmk_r1_sa **pos;
+
 	if (!r1)
 		return;
 
+	pos = &cache->pmk_r1_hash[FT_PMK_CACHE_HASH(r1->spa)];
+	while (*pos && *pos != r1)
+		pos = &(*pos)->hnext;
+	if (*pos)
+		*pos = r1->hnext;
 	dl_list_del(&r1->list);
-	eloop_cancel_timeout(wpa_ft_expire_pmk_r1, r1, NULL);
+	wpa_ft_pmk_exp_del(&r1->exp);
 
 	os_memset(r1->pmk_r1, 0, PMK_LEN_MAX);
 	os_free(r1->vlan);
@@ -1282,9 +1351,21 @@ static void wpa_ft_free_pmk_r1(struct wpa_ft_pmk_r1_sa *r1)
 
 static void wpa_ft_expire_pmk_r1(void *eloop_ctx, void *timeout_ctx)
 {
-	struct wpa_ft_pmk_r1_sa *r1 = eloop_ctx;
+	struct wpa_ft_pmk_cache *cache = eloop_ctx;
+	struct wpa_ft_pmk_exp *exp;
+	struct os_reltime now;
+
+	os_get_reltime(&now);
 
-	wpa_ft_free_pmk_r1(r1);
+	while ((exp = dl_list_first(&cache->pmk_r1_exp, struct wpa_ft_pmk_exp,
+				    list)) &&
+	       exp->time <= now.sec)
+		wpa_ft_free_pmk_r1(cache, dl_list_entry(exp,
+							struct wpa_ft_pmk_r1_sa,
+							exp));
+
+	wpa_ft_pmk_exp_schedule(cache, &cache->pmk_r1_exp,
+				wpa_ft_expire_pmk_r1);
 }
 
 
@@ -1296,6 +1377,8 @@ struct wpa_ft_pmk_cache * wpa_ft_pmk_cache_init(void)
 	if (cache) {
 		dl_list_init(&cache->pmk_r0);
 		dl_list_init(&cache->pmk_r1);
+		dl_list_init(&cache->pmk_r0_exp);
+		dl_list_init(&cache->pmk_r1_exp);
 	}
 
 	return cache;
@@ -1307,13 +1390,16 @@ void wpa_ft_pmk_cache_deinit(struct wpa_ft_pmk_cache *cache)
 	struct wpa_ft_pmk_r0_sa *r0, *r0prev;
 	struct wpa_ft_pmk_r1_sa *r1, *r1prev;
 
+	eloop_cancel_timeout(wpa_ft_expire_pmk_r0, cache, NULL);
+	eloop_cancel_timeout(wpa_ft_expire_pmk_r1, cache, NULL);
+
 	dl_list_for_each_safe(r0, r0prev, &cache->pmk_r0,
 			      struct wpa_ft_pmk_r0_sa, list)
-		wpa_ft_free_pmk_r0(r0);
+		wpa_ft_free_pmk_r0(cache, r0);
 
 	dl_list_for_each_safe(r1, r1prev, &cache->pmk_r1,
 			      struct wpa_ft_pmk_r1_sa, list)
-		wpa_ft_free_pmk_r1(r1);
+		wpa_ft_free_pmk_r1(cache, r1);
 
 	os_free(cache);
 }
@@ -1372,12 +1458,18 @@ static int wpa_ft_store_pmk_r0(struct wpa_authenticator *wpa_auth,
 		r0->session_timeout = now.sec + session_timeout;
 
 	dl_list_add(&cache->pmk_r0, &r0->list);
+	r0->hnext = cache->pmk_r0_hash[FT_PMK_CACHE_HASH(spa)];
+	cache->pmk_r0_hash[FT_PMK_CACHE_HASH(spa)] = r0;
+
+	/* Remove the entry when either the lifetime or the session timeout is
+	 * hit */
+	if (session_timeout > 0 &&
+	    (expires_in <= 0 || session_timeout < expires_in))
+		expires_in = session_timeout;
 	if (expires_in > 0)
-		eloop_register_timeout(expires_in + 1, 0, wpa_ft_expire_pmk_r0,
-				       r0, NULL);
-	if (session_timeout > 0)
-		eloop_register_timeout(session_timeout + 1, 0,
-				       wpa_ft_expire_pmk_r0, r0, NULL);
+		wpa_ft_pmk_exp_add(cache, &cache->pmk_r0_exp,
+				   wpa_ft_expire_pmk_r0, &r0->exp,
+				   now.sec + expires_in + 1);
 
 	return 0;
 }
@@ -1392,7 +1484,8 @@ static int wpa_ft_fetch_pmk_r0(struct wpa_authenticator *wpa_auth,
 	struct os_reltime now;
 
 	os_get_reltime(&now);
-	dl_list_for_each(r0, &cache->pmk_r0, struct wpa_ft_pmk_r0_sa, list) {
+	for (r0 = cache->pmk_r0_hash[FT_PMK_CACHE_HASH(spa)]; r0;
+	     r0 = r0->hnext) {
 		if (os_memcmp(r0->spa, spa, ETH_ALEN) == 0 &&
 		    os_memcmp_const(r0->pmk_r0_name, pmk_r0_name,
 				    WPA_PMK_NAME_LEN) == 0) {
@@ -1461,13 +1554,16 @@ static int wpa_ft_store_pmk_r1(struct wpa_authenticator *wpa_auth,
 		r1->session_timeout = now.sec + session_timeout;
 
 	dl_list_add(&cache->pmk_r1, &r1->list);
+	r1->hnext = cache->pmk_r1_hash[FT_PMK_CACHE_HASH(spa)];
+	cache->pmk_r1_hash[FT_PMK_CACHE_HASH(spa)] = r1;
 
+	if (session_timeout > 0 &&
+	    (expires_in <= 0 || session_timeout < expires_in))
+		expires_in = session_timeout;
 	if (expires_in > 0)
-		eloop_register_timeout(expires_in + 1, 0, wpa_ft_expire_pmk_r1,
-				       r1, NULL);
-	if (session_timeout > 0)
-		eloop_register_timeout(session_timeout + 1, 0,
-				       wpa_ft_expire_pmk_r1, r1, NULL);
+		wpa_ft_pmk_exp_add(cache, &cache->pmk_r1_exp,
+				   wpa_ft_expire_pmk_r1, &r1->exp,
+				   now.sec + expires_in + 1);
 
 	return 0;
 }
@@ -1487,7 +1583,8 @@ static int wpa_ft_fetch_pmk_r1(struct wpa_authenticator *wpa_auth,
 
 	os_get_reltime(&now);
 
-	dl_list_for_each(r1, &cache->pmk_r1, struct wpa_ft_pmk_r1_sa, list) {
+	for (r1 = cache->pmk_r1_hash[FT_PMK_CACHE_HASH(spa)]; r1;
+	     r1 = r1->hnext) {
 		if (os_memcmp(r1->spa, spa, ETH_ALEN) == 0 &&
 		    os_memcmp_const(r1->pmk_r1_name, pmk_r1_name,
 				    WPA_PMK_NAME_LEN) == 0) {
@@ -4741,6 +4838,7 @@ static int wpa_ft_generate_pmk_r1(struct wpa_authenticator *wpa_auth,
 		  .data = r1kh->id },
 		{ .type = FT_RRB_LAST_EMPTY, .len = 0, .data = NULL },
 	};
+	int res;
 
 	if (wpa_ft_new_seq(r1kh->seq, &f_seq) < 0) {
 		wpa_printf(MSG_DEBUG, "FT: Failed to get seq num");
@@ -4757,11 +4855,12 @@ static int wpa_ft_generate_pmk_r1(struct wpa_authenticator *wpa_auth,
 				&packet, &packet_len) < 0)
 		return -1;
 
-	wpa_ft_rrb_oui_send(wpa_auth, r1kh->addr, FT_PACKET_R0KH_R1KH_PUSH,
-			    packet, packet_len);
+	res = wpa_ft_rrb_oui_send(wpa_auth, r1kh->addr,
+				  FT_PACKET_R0KH_R1KH_PUSH,
+				  packet, packet_len);
 
 	os_free(packet);
-	return 0;
+	return res < 0 ? -1 : 0;
 }
 
 
@@ -4776,7 +4875,8 @@ void wpa_ft_push_pmk_r1(struct wpa_authenticator *wpa_auth, const u8 *addr)
 	if (!wpa_auth->conf.r1kh_list)
 		return;
 
-	dl_list_for_each(r0, &cache->pmk_r0, struct wpa_ft_pmk_r0_sa, list) {
+	for (r0 = cache->pmk_r0_hash[FT_PMK_CACHE_HASH(addr)]; r0;
+	     r0 = r0->hnext) {
 		if (os_memcmp(r0->spa, addr, ETH_ALEN) == 0) {
 			r0found = r0;
 			break;
@@ -4797,8 +4897,38 @@ void wpa_ft_push_pmk_r1(struct wpa_authenticator *wpa_auth, const u8 *addr)
 			continue;
 		if (wpa_ft_rrb_init_r1kh_seq(r1kh) < 0)
 			continue;
-		wpa_ft_generate_pmk_r1(wpa_auth, r0, r1kh, addr);
+		if (wpa_ft_generate_pmk_r1(wpa_auth, r0, r1kh, addr) < 0)
+			r1kh->push_failed++;
+		else
+			r1kh->push_sent++;
 	}
 }
 
+
+int wpa_ft_get_mib(struct wpa_authenticator *wpa_auth, char *buf,
+		   size_t buflen)
+{
+	struct ft_remote_r1kh *r1kh;
+	int len = 0, ret;
+
+	if (wpa_auth->conf.r1kh_list)
+		r1kh = *wpa_auth->conf.r1kh_list;
+	else
+		r1kh = NULL;
+	for (; r1kh; r1kh = r1kh->next) {
+		if (!r1kh->push_sent && !r1kh->push_failed)
+			continue;
+		ret = os_snprintf(buf + len, buflen - len,
+				  "hostapdFTPushR1KH=" MACSTR
+				  " sent=%u failed=%u\n",
+				  MAC2STR(r1kh->addr), r1kh->push_sent,
+				  r1kh->push_failed);
+		if (os_snprintf_error(buflen - len, ret))
+			return len;
+		len += ret;
+	}
+
+	return len;
+}
+
 #endif /* CONFIG_IEEE80211R_AP */
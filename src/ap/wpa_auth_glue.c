@@ -262,6 +262,44 @@ static void hostapd_wpa_auth_psk_failure_report(void *ctx, const u8 *addr)
 }
 
 
+static void hostapd_wpa_auth_psk_success_report(void *ctx, const u8 *addr,
+					       const u8 *psk, size_t psk_len)
+{
+	struct hostapd_data *hapd = ctx;
+	struct hostapd_psk_hint *hint;
+	struct hostapd_wpa_psk *wpa_psk = hapd->conf->ssid.wpa_psk;
+
+	/* Only needed when there are multiple PSKs to try */
+	if (!wpa_psk || !wpa_psk->next || psk_len != PMK_LEN)
+		return;
+
+	if (!hapd->psk_hints) {
+		hapd->psk_hints = os_calloc(STA_HASH_SIZE,
+					    sizeof(struct hostapd_psk_hint));
+		if (!hapd->psk_hints)
+			return;
+	}
+
+	hint = &hapd->psk_hints[STA_HASH(addr)];
+	os_memcpy(hint->addr, addr, ETH_ALEN);
+	os_memcpy(hint->psk, psk, PMK_LEN);
+}
+
+
+static const u8 * hostapd_psk_hint_get(struct hostapd_data *hapd,
+				       const u8 *addr)
+{
+	struct hostapd_psk_hint *hint;
+
+	if (!hapd->psk_hints)
+		return NULL;
+	hint = &hapd->psk_hints[STA_HASH(addr)];
+	if (os_memcmp(hint->addr, addr, ETH_ALEN) != 0)
+		return NULL;
+	return hint->psk;
+}
+
+
 static void hostapd_wpa_auth_set_eapol(void *ctx, const u8 *addr,
 				       wpa_eapol_variable var, int value)
 {
@@ -368,7 +406,7 @@ static const u8 * hostapd_wpa_auth_get_psk(void *ctx, const u8 *addr,
 #endif /* CONFIG_OWE */
 
 	psk = hostapd_get_psk(hapd->conf, addr, p2p_dev_addr, prev_psk,
-			      vlan_id);
+			      hostapd_psk_hint_get(hapd, addr), vlan_id);
 	/*
 	 * This is about to iterate over all psks, prev_psk gives the last
 	 * returned psk which should not be returned again.
@@ -1424,6 +1462,7 @@ int hostapd_setup_wpa(struct hostapd_data *hapd)
 		.disconnect = hostapd_wpa_auth_disconnect,
 		.mic_failure_report = hostapd_wpa_auth_mic_failure_report,
 		.psk_failure_report = hostapd_wpa_auth_psk_failure_report,
+		.psk_success_report = hostapd_wpa_auth_psk_success_report,
 		.set_eapol = hostapd_wpa_auth_set_eapol,
 		.get_eapol = hostapd_wpa_auth_get_eapol,
 		.get_psk = hostapd_wpa_auth_get_psk,
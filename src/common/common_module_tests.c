@@ -17,6 +17,7 @@
 #include "gas.h"
 #include "wpa_common.h"
 #include "sae.h"
+#include "ctrl_iface_common.h"
 
 
 struct ieee802_11_parse_test_data {
@@ -146,6 +147,93 @@ static int ieee802_11_parse_tests(void)
 }
 
 
+static int elem_index_check(const u8 *ies, size_t len)
+{
+	struct ieee802_11_elem_index *idx;
+	const struct element *elem;
+	unsigned int i;
+	int ret = 0;
+
+	idx = ieee802_11_elem_index_build(ies, len);
+	if (!idx)
+		return -1;
+
+	for (i = 0; i < 256; i++) {
+		if (ieee802_11_elem_index_get(idx, ies, i) !=
+		    get_ie(ies, len, i) ||
+		    ieee802_11_elem_index_get_ext(idx, ies, i) !=
+		    get_ie_ext(ies, len, i))
+			ret = -1;
+	}
+
+	for_each_element_id(elem, WLAN_EID_VENDOR_SPECIFIC, ies, len) {
+		u32 type;
+
+		if (elem->datalen < 4)
+			continue;
+		type = WPA_GET_BE32(elem->data);
+		if (ieee802_11_elem_index_get_vendor(idx, ies, type) !=
+		    get_vendor_ie(ies, len, type) ||
+		    ieee802_11_elem_index_get_vendor(idx, ies, type ^ 1) !=
+		    get_vendor_ie(ies, len, type ^ 1))
+			ret = -1;
+	}
+
+	os_free(idx);
+	return ret;
+}
+
+
+static int ieee802_11_elem_index_tests(void)
+{
+	const u8 ies[] = {
+		WLAN_EID_SSID, 3, 'a', 'b', 'c',
+		WLAN_EID_SUPP_RATES, 2, 0x82, 0x84,
+		WLAN_EID_VENDOR_SPECIFIC, 4, 0x00, 0x50, 0xf2, 0x01,
+		WLAN_EID_RSN, 2, 0x01, 0x00,
+		WLAN_EID_EXTENSION, 0,
+		WLAN_EID_EXTENSION, 2, WLAN_EID_EXT_HE_OPERATION, 0x11,
+		WLAN_EID_VENDOR_SPECIFIC, 3, 0x00, 0x50, 0xf2,
+		WLAN_EID_EXTENSION, 2, WLAN_EID_EXT_HE_OPERATION, 0x22,
+		WLAN_EID_VENDOR_SPECIFIC, 5, 0x00, 0x50, 0xf2, 0x04, 0x10,
+		WLAN_EID_VENDOR_SPECIFIC, 4, 0x00, 0x50, 0xf2, 0x01,
+		WLAN_EID_SSID, 1, 'x',
+		WLAN_EID_RSNX, 10, 0x20 /* truncated element */
+	};
+	u8 *big;
+	int i, ret = 0;
+
+	wpa_printf(MSG_INFO, "ieee802_11 element index tests");
+
+	for (i = 0; parse_tests[i].data; i++) {
+		if (elem_index_check(parse_tests[i].data,
+				     parse_tests[i].len) < 0) {
+			wpa_printf(MSG_ERROR,
+				   "ieee802_11 element index test %d failed",
+				   i);
+			ret = -1;
+		}
+	}
+
+	if (elem_index_check(ies, sizeof(ies)) < 0) {
+		wpa_printf(MSG_ERROR,
+			   "ieee802_11 element index test (multiple elements) failed");
+		ret = -1;
+	}
+
+	big = os_zalloc(0x10000);
+	if (!big || ieee802_11_elem_index_build(big, 0x10000) ||
+	    ieee802_11_elem_index_build(NULL, 0)) {
+		wpa_printf(MSG_ERROR,
+			   "ieee802_11 element index test (invalid buffer) failed");
+		ret = -1;
+	}
+	os_free(big);
+
+	return ret;
+}
+
+
 struct rsn_ie_parse_test_data {
 	u8 *data;
 	size_t len;
@@ -486,6 +574,27 @@ static int sae_tests(void)
 	if (!pt_info)
 		goto fail;
 
+	for (pt = pt_info; pt; pt = pt->next) {
+		struct sae_pt *pt2 = NULL;
+		u8 bin[SAE_MAX_PRIME_LEN], bin2[SAE_MAX_PRIME_LEN];
+		int len, len2 = -1;
+
+		len = sae_pt_to_bin(pt, bin, sizeof(bin));
+		if (len > 0)
+			pt2 = sae_pt_from_bin(pt->group, (const u8 *) ssid,
+					      os_strlen(ssid), bin, len);
+		if (pt2)
+			len2 = sae_pt_to_bin(pt2, bin2, sizeof(bin2));
+		sae_deinit_pt(pt2);
+		if (len <= 0 || len2 != len ||
+		    os_memcmp(bin, bin2, len) != 0) {
+			wpa_printf(MSG_ERROR,
+				   "SAE: PT binary encoding mismatch");
+			sae_deinit_pt(pt_info);
+			goto fail;
+		}
+	}
+
 	for (pt = pt_info; pt; pt = pt->next) {
 		if (pt->group == 19) {
 			struct crypto_ec_point *pwe;
@@ -637,6 +746,182 @@ static int sae_pk_tests(void)
 }
 
 
+static int ctrl_iface_cmd_name_tests(void)
+{
+#ifdef CONFIG_CTRL_IFACE_UNIX
+	static const struct {
+		const char *cmd;
+		const char *name;
+	} tests[] = {
+		{ "PING", "PING" },
+		{ "SET_NETWORK 0 psk \"secret\"", "SET_NETWORK" },
+		{ "IFNAME=wlan0 STATUS", "STATUS" },
+		{ "CTRL-RSP-PASSWORD-0:secret", "CTRL-RSP" },
+		{ "IFNAME=wlan0 CTRL-RSP-PIN-1:1234", "CTRL-RSP" },
+		{ "foo:secret bar", "(other)" },
+		{ "foo=secret", "(other)" },
+		{ "IFNAME=wlan0", "(other)" },
+		{ NULL, NULL }
+	};
+	char name[CTRL_IFACE_CMD_NAME_LEN];
+	unsigned int i;
+
+	wpa_printf(MSG_INFO, "ctrl_iface command name tests");
+
+	for (i = 0; tests[i].cmd; i++) {
+		ctrl_iface_cmd_name(tests[i].cmd, name, sizeof(name));
+		if (os_strcmp(name, tests[i].name) != 0) {
+			wpa_printf(MSG_ERROR,
+				   "ctrl_iface command name test %u failed: '%s'",
+				   i, name);
+			return -1;
+		}
+	}
+#endif /* CONFIG_CTRL_IFACE_UNIX */
+
+	return 0;
+}
+
+
+#ifdef CONFIG_CTRL_IFACE_UNIX
+static void event_ring_add_txt(struct ctrl_iface_event_ring *ring, int level,
+			       const char *txt)
+{
+	char levelstr[10];
+	struct iovec io[2];
+
+	os_snprintf(levelstr, sizeof(levelstr), "<%d>", level);
+	io[0].iov_base = levelstr;
+	io[0].iov_len = os_strlen(levelstr);
+	io[1].iov_base = (char *) txt;
+	io[1].iov_len = os_strlen(txt);
+	ctrl_iface_event_ring_add(ring, level, io, 2);
+}
+
+
+static int event_ring_pull_check(struct ctrl_iface_event_ring *ring,
+				 struct wpa_ctrl_dst *dst, size_t buflen,
+				 const char *expect)
+{
+	char buf[4096];
+	int len;
+
+	if (buflen > sizeof(buf) - 1)
+		return -1;
+	len = ctrl_iface_event_ring_pull(ring, dst, buf, buflen);
+	if (len < 0 || (size_t) len != os_strlen(expect) ||
+	    os_memcmp(buf, expect, len) != 0) {
+		if (len >= 0)
+			buf[len] = '\0';
+		wpa_printf(MSG_ERROR,
+			   "ctrl_iface event ring: unexpected response '%s' (expected '%s')",
+			   len < 0 ? "(error)" : buf, expect);
+		return -1;
+	}
+	return 0;
+}
+#endif /* CONFIG_CTRL_IFACE_UNIX */
+
+
+static int ctrl_iface_event_ring_tests(void)
+{
+#ifdef CONFIG_CTRL_IFACE_UNIX
+	struct ctrl_iface_event_ring *ring;
+	struct wpa_ctrl_dst dst;
+	char txt[20], buf[4096];
+	unsigned int i;
+	int len, ret = -1;
+
+	wpa_printf(MSG_INFO, "ctrl_iface event ring tests");
+
+	ring = os_zalloc(sizeof(*ring));
+	if (!ring)
+		return -1;
+	os_memset(&dst, 0, sizeof(dst));
+	dst.pull = 1;
+	dst.debug_level = MSG_INFO;
+
+	/* Nothing pending and a buffer too small for the header */
+	if (event_ring_pull_check(ring, &dst, 100, "pending=0 overruns=0\n") ||
+	    ctrl_iface_event_ring_pull(ring, &dst, buf, 50) != -1)
+		goto fail;
+
+	/* Events below the monitor level are skipped */
+	event_ring_add_txt(ring, MSG_INFO, "EV-0");
+	event_ring_add_txt(ring, MSG_DEBUG, "EV-dbg");
+	event_ring_add_txt(ring, MSG_INFO, "EV-1");
+	dst.notified = 1;
+	if (event_ring_pull_check(ring, &dst, 100,
+				  "pending=0 overruns=0\n<3>EV-0\n<3>EV-1\n") ||
+	    dst.sent != 2 || dst.notified || dst.cursor != ring->head)
+		goto fail;
+
+	/* Partial pull: room for exactly two of the three events */
+	event_ring_add_txt(ring, MSG_INFO, "EV-2");
+	event_ring_add_txt(ring, MSG_INFO, "EV-3");
+	event_ring_add_txt(ring, MSG_INFO, "EV-4");
+	dst.notified = 1;
+	if (event_ring_pull_check(ring, &dst, 50 + 2 * 8,
+				  "pending=1 overruns=0\n<3>EV-2\n<3>EV-3\n") ||
+	    !dst.notified ||
+	    event_ring_pull_check(ring, &dst, 50 + 2 * 8,
+				  "pending=0 overruns=0\n<3>EV-4\n") ||
+	    dst.notified)
+		goto fail;
+
+	/* An event that can never fit is dropped instead of stalling */
+	event_ring_add_txt(ring, MSG_INFO, "EV-too-long-for-the-buffer");
+	event_ring_add_txt(ring, MSG_INFO, "EV-5");
+	if (event_ring_pull_check(ring, &dst, 50 + 8,
+				  "pending=0 overruns=1\n<3>EV-5\n"))
+		goto fail;
+
+	/* Overrun: the monitor falls five events behind the ring size */
+	for (i = 0; i < CTRL_IFACE_EVENT_RING_SIZE + 5; i++) {
+		os_snprintf(txt, sizeof(txt), "OV-%u", i);
+		event_ring_add_txt(ring, MSG_INFO, txt);
+	}
+	len = ctrl_iface_event_ring_pull(ring, &dst, buf, sizeof(buf) - 1);
+	if (len < 0)
+		goto fail;
+	buf[len] = '\0';
+	if (os_strncmp(buf, "pending=0 overruns=6\n<3>OV-5\n<3>OV-6\n",
+		       37) != 0 ||
+	    os_strcmp(buf + len - 10, "<3>OV-260\n") != 0 ||
+	    dst.cursor != ring->head) {
+		wpa_printf(MSG_ERROR,
+			   "ctrl_iface event ring: unexpected overrun response");
+		goto fail;
+	}
+
+	/* Sequence numbers wrap around */
+	ring->head = 0xfffffffe;
+	dst.cursor = ring->head;
+	dst.overruns = 0;
+	event_ring_add_txt(ring, MSG_INFO, "WR-0");
+	event_ring_add_txt(ring, MSG_INFO, "WR-1");
+	event_ring_add_txt(ring, MSG_INFO, "WR-2");
+	if (ring->head != 1 ||
+	    event_ring_pull_check(ring, &dst, 50 + 8,
+				  "pending=2 overruns=0\n<3>WR-0\n") ||
+	    event_ring_pull_check(ring, &dst, 100,
+				  "pending=0 overruns=0\n<3>WR-1\n<3>WR-2\n") ||
+	    dst.cursor != 1)
+		goto fail;
+
+	ret = 0;
+fail:
+	if (ret)
+		wpa_printf(MSG_ERROR, "ctrl_iface event ring test failed");
+	ctrl_iface_event_ring_flush(ring);
+	os_free(ring);
+	return ret;
+#else /* CONFIG_CTRL_IFACE_UNIX */
+	return 0;
+#endif /* CONFIG_CTRL_IFACE_UNIX */
+}
+
+
 int common_module_tests(void)
 {
 	int ret = 0;
@@ -644,10 +929,13 @@ int common_module_tests(void)
 	wpa_printf(MSG_INFO, "common module tests");
 
 	if (ieee802_11_parse_tests() < 0 ||
+	    ieee802_11_elem_index_tests() < 0 ||
 	    gas_tests() < 0 ||
 	    sae_tests() < 0 ||
 	    sae_pk_tests() < 0 ||
-	    rsn_ie_parse_tests() < 0)
+	    rsn_ie_parse_tests() < 0 ||
+	    ctrl_iface_cmd_name_tests() < 0 ||
+	    ctrl_iface_event_ring_tests() < 0)
 		ret = -1;
 
 	return ret;
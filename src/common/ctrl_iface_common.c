@@ -12,6 +12,7 @@
 #include <sys/un.h>
 
 #include "utils/common.h"
+#include "wpa_ctrl.h"
 #include "ctrl_iface_common.h"
 
 static int sockaddr_compare(struct sockaddr_storage *a, socklen_t a_len,
@@ -74,8 +75,8 @@ static int sockaddr_compare(struct sockaddr_storage *a, socklen_t a_len,
 }
 
 
-void sockaddr_print(int level, const char *msg, struct sockaddr_storage *sock,
-		    socklen_t socklen)
+static int sockaddr_txt(const struct sockaddr_storage *sock, socklen_t socklen,
+			char *txt, size_t txt_len)
 {
 	switch (sock->ss_family) {
 #ifdef CONFIG_CTRL_IFACE_UDP
@@ -85,34 +86,41 @@ void sockaddr_print(int level, const char *msg, struct sockaddr_storage *sock,
 		char host[NI_MAXHOST] = { 0 };
 		char service[NI_MAXSERV] = { 0 };
 
-		getnameinfo((struct sockaddr *) sock, socklen,
+		getnameinfo((const struct sockaddr *) sock, socklen,
 			    host, sizeof(host),
 			    service, sizeof(service),
 			    NI_NUMERICHOST);
 
-		wpa_printf(level, "%s %s:%s", msg, host, service);
-		break;
+		os_snprintf(txt, txt_len, "%s:%s", host, service);
+		return 0;
 	}
 #endif /* CONFIG_CTRL_IFACE_UDP */
 #ifdef CONFIG_CTRL_IFACE_UNIX
 	case AF_UNIX:
-	{
-		char addr_txt[200];
-
-		printf_encode(addr_txt, sizeof(addr_txt),
-			      (u8 *) ((struct sockaddr_un *) sock)->sun_path,
+		printf_encode(txt, txt_len,
+			      (const u8 *)
+			      ((const struct sockaddr_un *) sock)->sun_path,
 			      socklen - offsetof(struct sockaddr_un, sun_path));
-		wpa_printf(level, "%s %s", msg, addr_txt);
-		break;
-	}
+		return 0;
 #endif /* CONFIG_CTRL_IFACE_UNIX */
 	default:
-		wpa_printf(level, "%s", msg);
-		break;
+		return -1;
 	}
 }
 
 
+void sockaddr_print(int level, const char *msg, struct sockaddr_storage *sock,
+		    socklen_t socklen)
+{
+	char addr_txt[200];
+
+	if (sockaddr_txt(sock, socklen, addr_txt, sizeof(addr_txt)) < 0)
+		wpa_printf(level, "%s", msg);
+	else
+		wpa_printf(level, "%s %s", msg, addr_txt);
+}
+
+
 static int ctrl_set_events(struct wpa_ctrl_dst *dst, const char *input)
 {
 	const char *value;
@@ -134,12 +142,29 @@ static int ctrl_set_events(struct wpa_ctrl_dst *dst, const char *input)
 			dst->events |= WPA_EVENT_RX_PROBE_REQUEST;
 		else
 			dst->events &= ~WPA_EVENT_RX_PROBE_REQUEST;
+	} else if (str_starts(input, "pull=")) {
+		dst->pull = val;
 	}
 
 	return 0;
 }
 
 
+struct wpa_ctrl_dst * ctrl_iface_get_dst(struct dl_list *ctrl_dst,
+					 struct sockaddr_storage *from,
+					 socklen_t fromlen)
+{
+	struct wpa_ctrl_dst *dst;
+
+	dl_list_for_each(dst, ctrl_dst, struct wpa_ctrl_dst, list) {
+		if (!sockaddr_compare(from, fromlen, &dst->addr, dst->addrlen))
+			return dst;
+	}
+
+	return NULL;
+}
+
+
 int ctrl_iface_attach(struct dl_list *ctrl_dst, struct sockaddr_storage *from,
 		      socklen_t fromlen, const char *input)
 {
@@ -207,3 +232,372 @@ int ctrl_iface_level(struct dl_list *ctrl_dst, struct sockaddr_storage *from,
 
 	return -1;
 }
+
+
+/**
+ * ctrl_iface_event_ring_add - Store an event for lagging monitors
+ * @ring: Event ring
+ * @level: Priority level of the event
+ * @io: Event message parts
+ * @iovcnt: Number of message parts
+ * Returns: Sequence number of the stored event
+ *
+ * The oldest event is overwritten if the ring is full. Monitors whose cursor
+ * still points to it will see that as an overrun.
+ */
+unsigned int ctrl_iface_event_ring_add(struct ctrl_iface_event_ring *ring,
+				       int level, const struct iovec *io,
+				       int iovcnt)
+{
+	struct ctrl_iface_event *ev;
+	size_t len = 0;
+	int i;
+	u8 *pos;
+
+	ev = &ring->ev[ring->head % CTRL_IFACE_EVENT_RING_SIZE];
+	os_free(ev->data);
+	ev->data = NULL;
+	ev->len = 0;
+	ev->level = level;
+
+	for (i = 0; i < iovcnt; i++)
+		len += io[i].iov_len;
+	ev->data = os_malloc(len);
+	if (ev->data) {
+		pos = ev->data;
+		for (i = 0; i < iovcnt; i++) {
+			os_memcpy(pos, io[i].iov_base, io[i].iov_len);
+			pos += io[i].iov_len;
+		}
+		ev->len = len;
+	}
+
+	return ring->head++;
+}
+
+
+/**
+ * ctrl_iface_event_ring_pull - Read pending events for a pull mode monitor
+ * @ring: Event ring
+ * @dst: Monitor in pull mode
+ * @buf: Buffer for the response
+ * @buflen: Length of buf
+ * Returns: Length of the response
+ *
+ * The response starts with a "pending=<count> overruns=<count>" line followed
+ * by one event per line as many as fit in the buffer. pending is the number of
+ * events still left in the ring after this response and overruns the total
+ * number of events the monitor has lost due to the ring wrapping around.
+ */
+int ctrl_iface_event_ring_pull(struct ctrl_iface_event_ring *ring,
+			       struct wpa_ctrl_dst *dst,
+			       char *buf, size_t buflen)
+{
+	struct ctrl_iface_event *ev;
+	char hdr[50];
+	char *pos, *end = buf + buflen;
+	unsigned int pending;
+	size_t hdr_len;
+	int ret;
+
+	pending = ring->head - dst->cursor;
+	if (pending > CTRL_IFACE_EVENT_RING_SIZE) {
+		dst->overruns += pending - CTRL_IFACE_EVENT_RING_SIZE;
+		dst->cursor = ring->head - CTRL_IFACE_EVENT_RING_SIZE;
+	}
+
+	/* Leave room for the header that is written once the count is known */
+	hdr_len = sizeof(hdr);
+	if (buflen <= hdr_len)
+		return -1;
+	pos = buf + hdr_len;
+
+	while (dst->cursor != ring->head) {
+		ev = &ring->ev[dst->cursor % CTRL_IFACE_EVENT_RING_SIZE];
+		if (ev->data && ev->level >= dst->debug_level) {
+			if (ev->len + 1 > (size_t) (end - pos)) {
+				if (pos != buf + hdr_len)
+					break;
+				/* Never fits; drop it instead of stalling */
+				dst->overruns++;
+				dst->cursor++;
+				continue;
+			}
+			os_memcpy(pos, ev->data, ev->len);
+			pos += ev->len;
+			*pos++ = '\n';
+			dst->sent++;
+		}
+		dst->cursor++;
+	}
+
+	pending = ring->head - dst->cursor;
+	if (!pending)
+		dst->notified = 0;
+
+	ret = os_snprintf(hdr, sizeof(hdr), "pending=%u overruns=%u\n",
+			  pending, dst->overruns);
+	if (os_snprintf_error(sizeof(hdr), ret))
+		return -1;
+	os_memmove(buf + ret, buf + hdr_len, pos - (buf + hdr_len));
+	os_memcpy(buf, hdr, ret);
+
+	return ret + (pos - (buf + hdr_len));
+}
+
+
+void ctrl_iface_event_ring_flush(struct ctrl_iface_event_ring *ring)
+{
+	unsigned int i;
+
+	for (i = 0; i < CTRL_IFACE_EVENT_RING_SIZE; i++) {
+		os_free(ring->ev[i].data);
+		ring->ev[i].data = NULL;
+		ring->ev[i].len = 0;
+	}
+}
+
+
+/**
+ * ctrl_iface_monitors - Write per-monitor delivery counters
+ * @ctrl_dst: List of attached monitors
+ * @ring: Event ring used for pull mode monitors or %NULL if not in use
+ * @buf: Buffer for the response
+ * @buflen: Length of buf
+ * Returns: Length of the response
+ */
+int ctrl_iface_monitors(struct dl_list *ctrl_dst,
+			const struct ctrl_iface_event_ring *ring,
+			char *buf, size_t buflen)
+{
+	struct wpa_ctrl_dst *dst;
+	char *pos = buf, *end = buf + buflen;
+	char addr_txt[200];
+	int ret;
+
+	dl_list_for_each(dst, ctrl_dst, struct wpa_ctrl_dst, list) {
+		unsigned int pending = 0, lost = 0;
+
+		if (dst->pull && ring) {
+			pending = ring->head - dst->cursor;
+			if (pending > CTRL_IFACE_EVENT_RING_SIZE) {
+				lost = pending - CTRL_IFACE_EVENT_RING_SIZE;
+				pending = CTRL_IFACE_EVENT_RING_SIZE;
+			}
+		}
+		if (sockaddr_txt(&dst->addr, dst->addrlen, addr_txt,
+				 sizeof(addr_txt)) < 0)
+			os_strlcpy(addr_txt, "?", sizeof(addr_txt));
+		ret = os_snprintf(pos, end - pos,
+				  "%s level=%d sent=%u pull=%d pending=%u overruns=%u\n",
+				  addr_txt, dst->debug_level, dst->sent,
+				  dst->pull, pending, dst->overruns + lost);
+		if (os_snprintf_error(end - pos, ret))
+			break;
+		pos += ret;
+	}
+
+	return pos - buf;
+}
+
+
+/*
+ * Per-command call counters and processing time. Commands are keyed by their
+ * first token so that, e.g., "SET foo 1" and "SET bar 2" share an entry. The
+ * number of distinct names is bounded to keep a misbehaving client from
+ * growing the table without limit; anything beyond that is accounted under a
+ * single catch-all entry.
+ */
+
+#define CTRL_IFACE_CMD_STATS_HASH_SIZE 64
+#define CTRL_IFACE_CMD_STATS_MAX 256
+#define CTRL_IFACE_CMD_STATS_OTHER "(other)"
+
+struct ctrl_iface_cmd_stat {
+	struct ctrl_iface_cmd_stat *hnext;
+	char name[CTRL_IFACE_CMD_NAME_LEN];
+	unsigned int count;
+	u64 total_usec;
+	unsigned int max_usec;
+};
+
+struct ctrl_iface_cmd_stats {
+	struct ctrl_iface_cmd_stat *hash[CTRL_IFACE_CMD_STATS_HASH_SIZE];
+	unsigned int num;
+};
+
+
+static unsigned int ctrl_iface_cmd_hash(const char *name)
+{
+	unsigned int h = 5381;
+
+	while (*name)
+		h = h * 33 + (unsigned char) *name++;
+	return h % CTRL_IFACE_CMD_STATS_HASH_SIZE;
+}
+
+
+static struct ctrl_iface_cmd_stat *
+ctrl_iface_cmd_stat_get(struct ctrl_iface_cmd_stats *stats, unsigned int h,
+			const char *name)
+{
+	struct ctrl_iface_cmd_stat *s;
+
+	for (s = stats->hash[h]; s; s = s->hnext) {
+		if (os_strcmp(s->name, name) == 0)
+			return s;
+	}
+
+	return NULL;
+}
+
+
+struct ctrl_iface_cmd_stats * ctrl_iface_cmd_stats_init(void)
+{
+	return os_zalloc(sizeof(struct ctrl_iface_cmd_stats));
+}
+
+
+void ctrl_iface_cmd_stats_flush(struct ctrl_iface_cmd_stats *stats)
+{
+	struct ctrl_iface_cmd_stat *s, *prev;
+	unsigned int i;
+
+	if (!stats)
+		return;
+
+	for (i = 0; i < CTRL_IFACE_CMD_STATS_HASH_SIZE; i++) {
+		s = stats->hash[i];
+		while (s) {
+			prev = s;
+			s = s->hnext;
+			os_free(prev);
+		}
+		stats->hash[i] = NULL;
+	}
+	stats->num = 0;
+}
+
+
+void ctrl_iface_cmd_stats_deinit(struct ctrl_iface_cmd_stats *stats)
+{
+	ctrl_iface_cmd_stats_flush(stats);
+	os_free(stats);
+}
+
+
+/**
+ * ctrl_iface_cmd_name - Extract the command name from a request
+ * @cmd: Control interface request
+ * @name: Buffer for the command name
+ * @name_len: Length of the name buffer
+ *
+ * The command handlers may modify the request buffer in place, so the name
+ * needs to be copied before the command is processed. A leading
+ * IFNAME=<ifname> prefix used on the global control interface is skipped.
+ *
+ * The name is reported back by CTRL_STATS, so it must not include any
+ * parameters. CTRL-RSP-<field>-<id>:<value> responses carry credentials in the
+ * first token and are all accounted under "CTRL-RSP". Any other token with a
+ * ':' or '=' separator is accounted under the catch-all entry.
+ */
+void ctrl_iface_cmd_name(const char *cmd, char *name, size_t name_len)
+{
+	const char *pos;
+	size_t i;
+
+	if (os_strncmp(cmd, "IFNAME=", 7) == 0) {
+		pos = os_strchr(cmd + 7, ' ');
+		if (pos)
+			cmd = pos + 1;
+	}
+
+	if (os_strncmp(cmd, WPA_CTRL_RSP, os_strlen(WPA_CTRL_RSP)) == 0) {
+		os_strlcpy(name, "CTRL-RSP", name_len);
+		return;
+	}
+
+	for (i = 0; cmd[i] && cmd[i] != ' '; i++) {
+		if (cmd[i] == ':' || cmd[i] == '=') {
+			os_strlcpy(name, CTRL_IFACE_CMD_STATS_OTHER, name_len);
+			return;
+		}
+	}
+
+	for (i = 0; i + 1 < name_len && cmd[i] && cmd[i] != ' '; i++)
+		name[i] = cmd[i];
+	name[i] = '\0';
+}
+
+
+void ctrl_iface_cmd_stats_add(struct ctrl_iface_cmd_stats *stats,
+			      const char *name, struct os_reltime *start)
+{
+	struct ctrl_iface_cmd_stat *s;
+	struct os_reltime now, diff;
+	unsigned int h, usec;
+
+	if (!stats)
+		return;
+
+	os_get_reltime(&now);
+	os_reltime_sub(&now, start, &diff);
+	if (diff.sec < 0)
+		usec = 0;
+	else if (diff.sec > 1000)
+		usec = 1000 * 1000000;
+	else
+		usec = diff.sec * 1000000 + diff.usec;
+
+	h = ctrl_iface_cmd_hash(name);
+	s = ctrl_iface_cmd_stat_get(stats, h, name);
+	if (!s && stats->num >= CTRL_IFACE_CMD_STATS_MAX) {
+		/* The catch-all entry itself is allowed to exceed the limit */
+		name = CTRL_IFACE_CMD_STATS_OTHER;
+		h = ctrl_iface_cmd_hash(name);
+		s = ctrl_iface_cmd_stat_get(stats, h, name);
+	}
+	if (!s) {
+		s = os_zalloc(sizeof(*s));
+		if (!s)
+			return;
+		os_strlcpy(s->name, name, sizeof(s->name));
+		s->hnext = stats->hash[h];
+		stats->hash[h] = s;
+		stats->num++;
+	}
+
+	s->count++;
+	s->total_usec += usec;
+	if (usec > s->max_usec)
+		s->max_usec = usec;
+}
+
+
+int ctrl_iface_cmd_stats_print(struct ctrl_iface_cmd_stats *stats,
+			       char *buf, size_t buflen)
+{
+	struct ctrl_iface_cmd_stat *s;
+	char *pos = buf, *end = buf + buflen;
+	unsigned int i;
+	int ret;
+
+	if (!stats)
+		return 0;
+
+	for (i = 0; i < CTRL_IFACE_CMD_STATS_HASH_SIZE; i++) {
+		for (s = stats->hash[i]; s; s = s->hnext) {
+			ret = os_snprintf(pos, end - pos,
+					  "%s count=%u avg_usec=%u max_usec=%u\n",
+					  s->name, s->count,
+					  (unsigned int) (s->total_usec /
+							  s->count),
+					  s->max_usec);
+			if (os_snprintf_error(end - pos, ret))
+				return pos - buf;
+			pos += ret;
+		}
+	}
+
+	return pos - buf;
+}
@@ -27,6 +27,34 @@ struct wpa_ctrl_dst {
 	int debug_level;
 	int errors;
 	u32 events; /* WPA_EVENT_* bitmap */
+	unsigned int sent;
+	unsigned int overruns;
+	int pull; /* events are read from the event ring with EVENTS */
+	int notified; /* EVENTS-PENDING sent and not yet pulled */
+	unsigned int cursor; /* next event ring sequence number (pull mode) */
+};
+
+#define CTRL_IFACE_EVENT_RING_SIZE 256
+
+struct ctrl_iface_event {
+	int level;
+	size_t len;
+	u8 *data;
+};
+
+/**
+ * struct ctrl_iface_event_ring - Recent events for pull mode monitors
+ *
+ * Events are stored here once regardless of the number of pull mode monitors
+ * (ATTACH pull=1). Instead of a datagram per event, each such monitor gets a
+ * single EVENTS-PENDING notification and then reads the ring at its own pace
+ * from its cursor (struct wpa_ctrl_dst::cursor). A monitor that falls more than
+ * CTRL_IFACE_EVENT_RING_SIZE events behind loses the oldest events, which is
+ * accounted in struct wpa_ctrl_dst::overruns.
+ */
+struct ctrl_iface_event_ring {
+	struct ctrl_iface_event ev[CTRL_IFACE_EVENT_RING_SIZE];
+	unsigned int head; /* sequence number of the next event */
 };
 
 void sockaddr_print(int level, const char *msg, struct sockaddr_storage *sock,
@@ -39,4 +67,31 @@ int ctrl_iface_detach(struct dl_list *ctrl_dst, struct sockaddr_storage *from,
 int ctrl_iface_level(struct dl_list *ctrl_dst, struct sockaddr_storage *from,
 		     socklen_t fromlen, const char *level);
 
+unsigned int ctrl_iface_event_ring_add(struct ctrl_iface_event_ring *ring,
+				       int level, const struct iovec *io,
+				       int iovcnt);
+int ctrl_iface_event_ring_pull(struct ctrl_iface_event_ring *ring,
+			       struct wpa_ctrl_dst *dst,
+			       char *buf, size_t buflen);
+void ctrl_iface_event_ring_flush(struct ctrl_iface_event_ring *ring);
+struct wpa_ctrl_dst * ctrl_iface_get_dst(struct dl_list *ctrl_dst,
+					 struct sockaddr_storage *from,
+					 socklen_t fromlen);
+int ctrl_iface_monitors(struct dl_list *ctrl_dst,
+			const struct ctrl_iface_event_ring *ring,
+			char *buf, size_t buflen);
+
+#define CTRL_IFACE_CMD_NAME_LEN 32
+
+struct ctrl_iface_cmd_stats;
+
+struct ctrl_iface_cmd_stats * ctrl_iface_cmd_stats_init(void);
+void ctrl_iface_cmd_stats_deinit(struct ctrl_iface_cmd_stats *stats);
+void ctrl_iface_cmd_stats_flush(struct ctrl_iface_cmd_stats *stats);
+void ctrl_iface_cmd_name(const char *cmd, char *name, size_t name_len);
+void ctrl_iface_cmd_stats_add(struct ctrl_iface_cmd_stats *stats,
+			      const char *name, struct os_reltime *start);
+int ctrl_iface_cmd_stats_print(struct ctrl_iface_cmd_stats *stats,
+			       char *buf, size_t buflen);
+
 #endif /* CONTROL_IFACE_COMMON_H */
@@ -1992,6 +1992,182 @@ const u8 * get_vendor_ie(const u8 *ies, size_t len, u32 vendor_type)
 }
 
 
+/*
+ * Element index: a bitmap of the element IDs (and Element ID Extensions)
+ * present in an IEs buffer with the offset of the first matching element for
+ * each of them, and the offsets of all Vendor Specific elements. An offset is
+ * found by counting the set bits below the ID in the bitmap.
+ */
+struct ieee802_11_elem_index {
+	u32 eid[8];
+	u32 ext[8];
+	u16 eid_base[8];
+	u16 ext_base[8];
+	u16 num_eid;
+	u16 num_ext;
+	u16 num_vendor;
+	u16 off[]; /* num_eid + num_ext + num_vendor entries */
+};
+
+#define ELEM_INDEX_NO_OFFSET 0xffff
+
+
+static unsigned int elem_index_popcount(u32 val)
+{
+	val = val - ((val >> 1) & 0x55555555);
+	val = (val & 0x33333333) + ((val >> 2) & 0x33333333);
+	return (((val + (val >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
+
+static u16 elem_index_bases(const u32 *bitmap, u16 *base)
+{
+	unsigned int i;
+	u16 count = 0;
+
+	for (i = 0; i < 8; i++) {
+		base[i] = count;
+		count += elem_index_popcount(bitmap[i]);
+	}
+
+	return count;
+}
+
+
+static int elem_index_slot(const u32 *bitmap, const u16 *base, u8 id)
+{
+	u32 bit = BIT(id % 32);
+
+	if (!(bitmap[id / 32] & bit))
+		return -1;
+	return base[id / 32] +
+		elem_index_popcount(bitmap[id / 32] & (bit - 1));
+}
+
+
+/**
+ * ieee802_11_elem_index_build - Build an element index for an IEs buffer
+ * @ies: Information elements buffer
+ * @len: Information elements buffer length
+ * Returns: Allocated element index or %NULL on failure
+ *
+ * The index stores only offsets, so it remains valid for a copy of the same
+ * IEs buffer. Lookups with the index return the same element as get_ie(),
+ * get_ie_ext(), and get_vendor_ie() would for the buffer. The returned index
+ * is freed with os_free().
+ */
+struct ieee802_11_elem_index * ieee802_11_elem_index_build(const u8 *ies,
+							   size_t len)
+{
+	struct ieee802_11_elem_index *idx, tmp;
+	const struct element *elem;
+	size_t num;
+	u16 *vendor;
+	int slot;
+
+	if (!ies || len > ELEM_INDEX_NO_OFFSET)
+		return NULL;
+
+	os_memset(&tmp, 0, sizeof(tmp));
+	for_each_element(elem, ies, len) {
+		tmp.eid[elem->id / 32] |= BIT(elem->id % 32);
+		if (elem->id == WLAN_EID_EXTENSION && elem->datalen > 0)
+			tmp.ext[elem->data[0] / 32] |= BIT(elem->data[0] % 32);
+		if (elem->id == WLAN_EID_VENDOR_SPECIFIC && elem->datalen >= 4)
+			tmp.num_vendor++;
+	}
+	tmp.num_eid = elem_index_bases(tmp.eid, tmp.eid_base);
+	tmp.num_ext = elem_index_bases(tmp.ext, tmp.ext_base);
+
+	num = tmp.num_eid + tmp.num_ext + tmp.num_vendor;
+	idx = os_malloc(sizeof(*idx) + num * sizeof(u16));
+	if (!idx)
+		return NULL;
+	os_memcpy(idx, &tmp, sizeof(tmp));
+	os_memset(idx->off, 0xff,
+		  (tmp.num_eid + tmp.num_ext) * sizeof(u16));
+	vendor = &idx->off[tmp.num_eid + tmp.num_ext];
+
+	for_each_element(elem, ies, len) {
+		u16 off = (const u8 *) elem - ies;
+
+		slot = elem_index_slot(idx->eid, idx->eid_base, elem->id);
+		if (idx->off[slot] == ELEM_INDEX_NO_OFFSET)
+			idx->off[slot] = off;
+		if (elem->id == WLAN_EID_EXTENSION && elem->datalen > 0) {
+			slot = idx->num_eid +
+				elem_index_slot(idx->ext, idx->ext_base,
+						elem->data[0]);
+			if (idx->off[slot] == ELEM_INDEX_NO_OFFSET)
+				idx->off[slot] = off;
+		}
+		if (elem->id == WLAN_EID_VENDOR_SPECIFIC && elem->datalen >= 4)
+			*vendor++ = off;
+	}
+
+	return idx;
+}
+
+
+/**
+ * ieee802_11_elem_index_get - Fetch an information element using an index
+ * @idx: Element index from ieee802_11_elem_index_build() for @ies
+ * @ies: Information elements buffer
+ * @eid: Information element identifier (WLAN_EID_*)
+ * Returns: Pointer to the first matching information element (id field) or
+ * %NULL if not found
+ */
+const u8 * ieee802_11_elem_index_get(const struct ieee802_11_elem_index *idx,
+				     const u8 *ies, u8 eid)
+{
+	int slot = elem_index_slot(idx->eid, idx->eid_base, eid);
+
+	return slot < 0 ? NULL : ies + idx->off[slot];
+}
+
+
+/**
+ * ieee802_11_elem_index_get_ext - Fetch an extended element using an index
+ * @idx: Element index from ieee802_11_elem_index_build() for @ies
+ * @ies: Information elements buffer
+ * @ext: Information element extension identifier (WLAN_EID_EXT_*)
+ * Returns: Pointer to the first matching information element (id field) or
+ * %NULL if not found
+ */
+const u8 *
+ieee802_11_elem_index_get_ext(const struct ieee802_11_elem_index *idx,
+			      const u8 *ies, u8 ext)
+{
+	int slot = elem_index_slot(idx->ext, idx->ext_base, ext);
+
+	return slot < 0 ? NULL : ies + idx->off[idx->num_eid + slot];
+}
+
+
+/**
+ * ieee802_11_elem_index_get_vendor - Fetch a vendor element using an index
+ * @idx: Element index from ieee802_11_elem_index_build() for @ies
+ * @ies: Information elements buffer
+ * @vendor_type: Vendor type (four octets starting the IE payload)
+ * Returns: Pointer to the first matching information element (id field) or
+ * %NULL if not found
+ */
+const u8 *
+ieee802_11_elem_index_get_vendor(const struct ieee802_11_elem_index *idx,
+				 const u8 *ies, u32 vendor_type)
+{
+	const u16 *off = &idx->off[idx->num_eid + idx->num_ext];
+	unsigned int i;
+
+	for (i = 0; i < idx->num_vendor; i++) {
+		if (WPA_GET_BE32(&ies[off[i] + 2]) == vendor_type)
+			return ies + off[i];
+	}
+
+	return NULL;
+}
+
+
 size_t mbo_add_ie(u8 *buf, size_t len, const u8 *attr, size_t attr_len)
 {
 	/*
@@ -244,6 +244,18 @@ const u8 * get_ie(const u8 *ies, size_t len, u8 eid);
 const u8 * get_ie_ext(const u8 *ies, size_t len, u8 ext);
 const u8 * get_vendor_ie(const u8 *ies, size_t len, u32 vendor_type);
 
+struct ieee802_11_elem_index;
+struct ieee802_11_elem_index * ieee802_11_elem_index_build(const u8 *ies,
+							   size_t len);
+const u8 * ieee802_11_elem_index_get(const struct ieee802_11_elem_index *idx,
+				     const u8 *ies, u8 eid);
+const u8 *
+ieee802_11_elem_index_get_ext(const struct ieee802_11_elem_index *idx,
+			      const u8 *ies, u8 ext);
+const u8 *
+ieee802_11_elem_index_get_vendor(const struct ieee802_11_elem_index *idx,
+				 const u8 *ies, u32 vendor_type);
+
 size_t mbo_add_ie(u8 *buf, size_t len, const u8 *attr, size_t attr_len);
 
 size_t add_multi_ap_ie(u8 *buf, size_t len, u8 value);
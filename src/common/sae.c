@@ -1128,6 +1128,89 @@ struct sae_pt * sae_derive_pt(int *groups, const u8 *ssid, size_t ssid_len,
 }
 
 
+/**
+ * sae_pt_to_bin - Write the PT of a single group as binary data
+ * @pt: PT from sae_derive_pt() (only the first entry is used)
+ * @buf: Buffer for the PT
+ * @buflen: Length of the buffer in octets
+ * Returns: Length of the PT in octets or -1 on failure
+ *
+ * ECC PTs are written as x and y coordinates and FFC PTs as the element, each
+ * padded to the length of the prime.
+ */
+int sae_pt_to_bin(const struct sae_pt *pt, u8 *buf, size_t buflen)
+{
+	size_t prime_len;
+
+	if (pt->ec) {
+		prime_len = crypto_ec_prime_len(pt->ec);
+		if (buflen < 2 * prime_len ||
+		    crypto_ec_point_to_bin(pt->ec, pt->ecc_pt, buf,
+					   buf + prime_len) < 0)
+			return -1;
+		return 2 * prime_len;
+	}
+
+	if (pt->dh)
+		return crypto_bignum_to_bin(pt->ffc_pt, buf, buflen,
+					    pt->dh->prime_len);
+
+	return -1;
+}
+
+
+/**
+ * sae_pt_from_bin - Create a PT from binary data
+ * @group: Group of the PT
+ * @ssid: SSID that was used to derive the PT
+ * @ssid_len: Length of the SSID in octets
+ * @buf: PT from sae_pt_to_bin()
+ * @len: Length of the PT in octets
+ * Returns: PT for the group or %NULL on failure; to be freed with
+ * sae_deinit_pt()
+ */
+struct sae_pt * sae_pt_from_bin(int group, const u8 *ssid, size_t ssid_len,
+				const u8 *buf, size_t len)
+{
+	struct sae_pt *pt;
+
+	if (ssid_len > 32)
+		return NULL;
+
+	pt = os_zalloc(sizeof(*pt));
+	if (!pt)
+		return NULL;
+
+#ifdef CONFIG_SAE_PK
+	os_memcpy(pt->ssid, ssid, ssid_len);
+	pt->ssid_len = ssid_len;
+#endif /* CONFIG_SAE_PK */
+	pt->group = group;
+	pt->ec = crypto_ec_init(group);
+	if (pt->ec) {
+		if (len != 2 * crypto_ec_prime_len(pt->ec))
+			goto fail;
+		pt->ecc_pt = crypto_ec_point_from_bin(pt->ec, buf);
+		if (!pt->ecc_pt ||
+		    !crypto_ec_point_is_on_curve(pt->ec, pt->ecc_pt))
+			goto fail;
+		return pt;
+	}
+
+	pt->dh = dh_groups_get(group);
+	if (!pt->dh || len != pt->dh->prime_len)
+		goto fail;
+	pt->ffc_pt = crypto_bignum_init_set(buf, len);
+	if (!pt->ffc_pt)
+		goto fail;
+
+	return pt;
+fail:
+	sae_deinit_pt(pt);
+	return NULL;
+}
+
+
 static void sae_max_min_addr(const u8 *addr[], size_t len[],
 			     const u8 *addr1, const u8 *addr2)
 {
@@ -148,6 +148,9 @@ struct crypto_bignum *
 sae_derive_pwe_from_pt_ffc(const struct sae_pt *pt,
 			   const u8 *addr1, const u8 *addr2);
 void sae_deinit_pt(struct sae_pt *pt);
+int sae_pt_to_bin(const struct sae_pt *pt, u8 *buf, size_t buflen);
+struct sae_pt * sae_pt_from_bin(int group, const u8 *ssid, size_t ssid_len,
+				const u8 *buf, size_t len);
 
 /* sae_pk.c */
 #ifdef CONFIG_SAE_PK
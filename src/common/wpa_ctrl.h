@@ -32,6 +32,8 @@ extern "C" {
 #define WPA_EVENT_AUTH_REJECT "CTRL-EVENT-AUTH-REJECT "
 /** wpa_supplicant is exiting */
 #define WPA_EVENT_TERMINATING "CTRL-EVENT-TERMINATING "
+/** Events are waiting in the event ring for a pull mode monitor (EVENTS) */
+#define WPA_EVENT_EVENTS_PENDING "CTRL-EVENT-EVENTS-PENDING "
 /** Password change was completed successfully */
 #define WPA_EVENT_PASSWORD_CHANGED "CTRL-EVENT-PASSWORD-CHANGED "
 /** EAP-Request/Notification received */
@@ -334,6 +336,8 @@ extern "C" {
 
 #define AP_EVENT_ENABLED "AP-ENABLED "
 #define AP_EVENT_DISABLED "AP-DISABLED "
+/* BSS reconfigured on configuration reload: changed=<item>[,<item>...] */
+#define AP_EVENT_BSS_RELOADED "AP-BSS-RELOADED "
 
 #define INTERFACE_ENABLED "INTERFACE-ENABLED "
 #define INTERFACE_DISABLED "INTERFACE-DISABLED "
@@ -11,8 +11,14 @@
 
 #include "common.h"
 #include "aes.h"
+#include "aes_i.h"
 #include "aes_wrap.h"
 
+#ifdef AES_ACCEL_X86
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#endif /* AES_ACCEL_X86 */
+
 static void inc32(u8 *block)
 {
 	u32 val;
@@ -33,66 +39,179 @@ static void xor_block(u8 *dst, const u8 *src)
 }
 
 
-static void shift_right_block(u8 *v)
-{
-	u32 val;
+/*
+ * GHASH key: hash subkey H and, for the portable implementation, a table of
+ * the 16 multiples of H by 4-bit polynomials (Shoup's method).
+ */
+struct ghash_key {
+	u8 h[16];
+	u64 hh[16], hl[16];
+};
 
-	val = WPA_GET_BE32(v + 12);
-	val >>= 1;
-	if (v[11] & 0x01)
-		val |= 0x80000000;
-	WPA_PUT_BE32(v + 12, val);
-
-	val = WPA_GET_BE32(v + 8);
-	val >>= 1;
-	if (v[7] & 0x01)
-		val |= 0x80000000;
-	WPA_PUT_BE32(v + 8, val);
-
-	val = WPA_GET_BE32(v + 4);
-	val >>= 1;
-	if (v[3] & 0x01)
-		val |= 0x80000000;
-	WPA_PUT_BE32(v + 4, val);
-
-	val = WPA_GET_BE32(v);
-	val >>= 1;
-	WPA_PUT_BE32(v, val);
-}
 
+/* Reduction constants for the 4 bits shifted out in gf_mult() */
+static const u64 gf_last4[16] = {
+	0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
 
-/* Multiplication in GF(2^128) */
-static void gf_mult(const u8 *x, const u8 *y, u8 *z)
+
+static void ghash_key_table(struct ghash_key *key)
 {
-	u8 v[16];
+	u64 vh, vl;
 	int i, j;
 
-	os_memset(z, 0, 16); /* Z_0 = 0^128 */
-	os_memcpy(v, y, 16); /* V_0 = Y */
-
-	for (i = 0; i < 16; i++) {
-		for (j = 0; j < 8; j++) {
-			if (x[i] & BIT(7 - j)) {
-				/* Z_(i + 1) = Z_i XOR V_i */
-				xor_block(z, v);
-			} else {
-				/* Z_(i + 1) = Z_i */
-			}
-
-			if (v[15] & 0x01) {
-				/* V_(i + 1) = (V_i >> 1) XOR R */
-				shift_right_block(v);
-				/* R = 11100001 || 0^120 */
-				v[0] ^= 0xe1;
-			} else {
-				/* V_(i + 1) = V_i >> 1 */
-				shift_right_block(v);
-			}
+	/* Bit order is reflected: index 8 (1000b) corresponds to H itself */
+	vh = WPA_GET_BE64(key->h);
+	vl = WPA_GET_BE64(key->h + 8);
+	key->hh[0] = key->hl[0] = 0;
+	key->hh[8] = vh;
+	key->hl[8] = vl;
+
+	for (i = 4; i > 0; i >>= 1) {
+		/* V = V * x, i.e., shift right with reduction by R */
+		u64 r = (vl & 1) ? 0xe100000000000000ULL : 0;
+
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ r;
+		key->hh[i] = vh;
+		key->hl[i] = vl;
+	}
+
+	for (i = 2; i <= 8; i <<= 1) {
+		for (j = 1; j < i; j++) {
+			key->hh[i + j] = key->hh[i] ^ key->hh[j];
+			key->hl[i + j] = key->hl[i] ^ key->hl[j];
 		}
 	}
 }
 
 
+/* Multiplication in GF(2^128): z = x * H */
+static void gf_mult(const struct ghash_key *key, const u8 *x, u8 *z)
+{
+	u64 zh, zl;
+	u8 idx, rem;
+	int i;
+
+	zh = zl = 0;
+	for (i = 15; i >= 0; i--) {
+		idx = x[i] & 0x0f;
+		if (i != 15) {
+			rem = zl & 0x0f;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (gf_last4[rem] << 48);
+		}
+		zh ^= key->hh[idx];
+		zl ^= key->hl[idx];
+
+		idx = x[i] >> 4;
+		rem = zl & 0x0f;
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4) ^ (gf_last4[rem] << 48);
+		zh ^= key->hh[idx];
+		zl ^= key->hl[idx];
+	}
+
+	WPA_PUT_BE64(z, zh);
+	WPA_PUT_BE64(z + 8, zl);
+}
+
+
+#ifdef AES_ACCEL_X86
+
+static int gcm_clmul = -1;
+
+
+static int gcm_clmul_available(void)
+{
+	if (gcm_clmul < 0)
+		gcm_clmul = aes_x86_cpu_has(AES_X86_CPUID_PCLMULQDQ |
+					    AES_X86_CPUID_SSSE3);
+	return gcm_clmul;
+}
+
+
+/*
+ * Carry-less multiplication with reduction modulo the GCM polynomial for
+ * byte-reflected operands as described in the Intel Carry-Less Multiplication
+ * Instruction and its Usage for Computing the GCM Mode white paper.
+ */
+static __m128i __attribute__((target("pclmul,sse2")))
+gf_mult_clmul(__m128i a, __m128i b)
+{
+	__m128i lo, hi, mid, t1, t2, t3;
+
+	lo = _mm_clmulepi64_si128(a, b, 0x00);
+	hi = _mm_clmulepi64_si128(a, b, 0x11);
+	mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+			    _mm_clmulepi64_si128(a, b, 0x01));
+	lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+	hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+	/* Shift the 256-bit product left by one bit */
+	t1 = _mm_srli_epi32(lo, 31);
+	t2 = _mm_srli_epi32(hi, 31);
+	lo = _mm_slli_epi32(lo, 1);
+	hi = _mm_slli_epi32(hi, 1);
+	t3 = _mm_srli_si128(t1, 12);
+	t2 = _mm_slli_si128(t2, 4);
+	t1 = _mm_slli_si128(t1, 4);
+	lo = _mm_or_si128(lo, t1);
+	hi = _mm_or_si128(_mm_or_si128(hi, t2), t3);
+
+	/* Reduce */
+	t1 = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31),
+					 _mm_slli_epi32(lo, 30)),
+			   _mm_slli_epi32(lo, 25));
+	t2 = _mm_srli_si128(t1, 4);
+	t1 = _mm_slli_si128(t1, 12);
+	lo = _mm_xor_si128(lo, t1);
+	t3 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1),
+					 _mm_srli_epi32(lo, 2)),
+			   _mm_srli_epi32(lo, 7));
+	t3 = _mm_xor_si128(t3, t2);
+	lo = _mm_xor_si128(lo, t3);
+	return _mm_xor_si128(hi, lo);
+}
+
+
+static void __attribute__((target("pclmul,ssse3,sse2")))
+ghash_clmul(const struct ghash_key *key, const u8 *x, size_t xlen, u8 *y)
+{
+	const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+					   8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i h, acc;
+	u8 tmp[16];
+	size_t last;
+
+	h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) key->h), bswap);
+	acc = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) y), bswap);
+
+	for (; xlen >= 16; x += 16, xlen -= 16) {
+		acc = _mm_xor_si128(acc, _mm_shuffle_epi8(
+					    _mm_loadu_si128((const __m128i *) x),
+					    bswap));
+		acc = gf_mult_clmul(acc, h);
+	}
+
+	if (xlen) {
+		/* Add zero padded last block */
+		last = xlen;
+		os_memcpy(tmp, x, last);
+		os_memset(tmp + last, 0, sizeof(tmp) - last);
+		acc = _mm_xor_si128(acc, _mm_shuffle_epi8(
+					    _mm_loadu_si128((__m128i *) tmp),
+					    bswap));
+		acc = gf_mult_clmul(acc, h);
+	}
+
+	_mm_storeu_si128((__m128i *) y, _mm_shuffle_epi8(acc, bswap));
+}
+
+#endif /* AES_ACCEL_X86 */
+
+
 static void ghash_start(u8 *y)
 {
 	/* Y_0 = 0^128 */
@@ -100,12 +219,20 @@ static void ghash_start(u8 *y)
 }
 
 
-static void ghash(const u8 *h, const u8 *x, size_t xlen, u8 *y)
+static void ghash(const struct ghash_key *key, const u8 *x, size_t xlen,
+		  u8 *y)
 {
 	size_t m, i;
 	const u8 *xpos = x;
 	u8 tmp[16];
 
+#ifdef AES_ACCEL_X86
+	if (gcm_clmul > 0) {
+		ghash_clmul(key, x, xlen, y);
+		return;
+	}
+#endif /* AES_ACCEL_X86 */
+
 	m = xlen / 16;
 
 	for (i = 0; i < m; i++) {
@@ -116,7 +243,7 @@ static void ghash(const u8 *h, const u8 *x, size_t xlen, u8 *y)
 		/* dot operation:
 		 * multiplication operation for binary Galois (finite) field of
 		 * 2^128 elements */
-		gf_mult(y, h, tmp);
+		gf_mult(key, y, tmp);
 		os_memcpy(y, tmp, 16);
 	}
 
@@ -132,7 +259,7 @@ static void ghash(const u8 *h, const u8 *x, size_t xlen, u8 *y)
 		/* dot operation:
 		 * multiplication operation for binary Galois (finite) field of
 		 * 2^128 elements */
-		gf_mult(y, h, tmp);
+		gf_mult(key, y, tmp);
 		os_memcpy(y, tmp, 16);
 	}
 
@@ -172,7 +299,8 @@ static void aes_gctr(void *aes, const u8 *icb, const u8 *x, size_t xlen, u8 *y)
 }
 
 
-static void * aes_gcm_init_hash_subkey(const u8 *key, size_t key_len, u8 *H)
+static void * aes_gcm_init_hash_subkey(const u8 *key, size_t key_len,
+				       struct ghash_key *H)
 {
 	void *aes;
 
@@ -181,15 +309,21 @@ static void * aes_gcm_init_hash_subkey(const u8 *key, size_t key_len, u8 *H)
 		return NULL;
 
 	/* Generate hash subkey H = AES_K(0^128) */
-	os_memset(H, 0, AES_BLOCK_SIZE);
-	aes_encrypt(aes, H, H);
+	os_memset(H->h, 0, AES_BLOCK_SIZE);
+	aes_encrypt(aes, H->h, H->h);
 	wpa_hexdump_key(MSG_EXCESSIVE, "Hash subkey H for GHASH",
-			H, AES_BLOCK_SIZE);
+			H->h, AES_BLOCK_SIZE);
+#ifdef AES_ACCEL_X86
+	if (gcm_clmul_available())
+		return aes;
+#endif /* AES_ACCEL_X86 */
+	ghash_key_table(H);
 	return aes;
 }
 
 
-static void aes_gcm_prepare_j0(const u8 *iv, size_t iv_len, const u8 *H, u8 *J0)
+static void aes_gcm_prepare_j0(const u8 *iv, size_t iv_len,
+			       const struct ghash_key *H, u8 *J0)
 {
 	u8 len_buf[16];
 
@@ -226,7 +360,8 @@ static void aes_gcm_gctr(void *aes, const u8 *J0, const u8 *in, size_t len,
 }
 
 
-static void aes_gcm_ghash(const u8 *H, const u8 *aad, size_t aad_len,
+static void aes_gcm_ghash(const struct ghash_key *H, const u8 *aad,
+			  size_t aad_len,
 			  const u8 *crypt, size_t crypt_len, u8 *S)
 {
 	u8 len_buf[16];
@@ -255,21 +390,21 @@ int aes_gcm_ae(const u8 *key, size_t key_len, const u8 *iv, size_t iv_len,
 	       const u8 *plain, size_t plain_len,
 	       const u8 *aad, size_t aad_len, u8 *crypt, u8 *tag)
 {
-	u8 H[AES_BLOCK_SIZE];
+	struct ghash_key H;
 	u8 J0[AES_BLOCK_SIZE];
 	u8 S[16];
 	void *aes;
 
-	aes = aes_gcm_init_hash_subkey(key, key_len, H);
+	aes = aes_gcm_init_hash_subkey(key, key_len, &H);
 	if (aes == NULL)
 		return -1;
 
-	aes_gcm_prepare_j0(iv, iv_len, H, J0);
+	aes_gcm_prepare_j0(iv, iv_len, &H, J0);
 
 	/* C = GCTR_K(inc_32(J_0), P) */
 	aes_gcm_gctr(aes, J0, plain, plain_len, crypt);
 
-	aes_gcm_ghash(H, aad, aad_len, crypt, plain_len, S);
+	aes_gcm_ghash(&H, aad, aad_len, crypt, plain_len, S);
 
 	/* T = MSB_t(GCTR_K(J_0, S)) */
 	aes_gctr(aes, J0, S, sizeof(S), tag);
@@ -289,21 +424,21 @@ int aes_gcm_ad(const u8 *key, size_t key_len, const u8 *iv, size_t iv_len,
 	       const u8 *crypt, size_t crypt_len,
 	       const u8 *aad, size_t aad_len, const u8 *tag, u8 *plain)
 {
-	u8 H[AES_BLOCK_SIZE];
+	struct ghash_key H;
 	u8 J0[AES_BLOCK_SIZE];
 	u8 S[16], T[16];
 	void *aes;
 
-	aes = aes_gcm_init_hash_subkey(key, key_len, H);
+	aes = aes_gcm_init_hash_subkey(key, key_len, &H);
 	if (aes == NULL)
 		return -1;
 
-	aes_gcm_prepare_j0(iv, iv_len, H, J0);
+	aes_gcm_prepare_j0(iv, iv_len, &H, J0);
 
 	/* P = GCTR_K(inc_32(J_0), C) */
 	aes_gcm_gctr(aes, J0, crypt, crypt_len, plain);
 
-	aes_gcm_ghash(H, aad, aad_len, crypt, crypt_len, S);
+	aes_gcm_ghash(&H, aad, aad_len, crypt, crypt_len, S);
 
 	/* T' = MSB_t(GCTR_K(J_0, S)) */
 	aes_gctr(aes, J0, S, sizeof(S), T);
@@ -20,6 +20,40 @@
 #include "crypto.h"
 #include "aes_i.h"
 
+int aes_accel_disabled;
+
+#ifdef AES_ACCEL_X86
+#include <wmmintrin.h>
+
+static int aes_ni = -1;
+
+
+static int aes_ni_available(void)
+{
+	if (aes_ni < 0)
+		aes_ni = aes_x86_cpu_has(AES_X86_CPUID_AES);
+	return aes_ni;
+}
+
+
+/* rk[] contains the round keys in the byte order used by AESENC */
+static void __attribute__((target("aes,sse2")))
+aes_ni_encrypt(const u32 rk[], int Nr, const u8 pt[16], u8 ct[16])
+{
+	const __m128i *k = (const __m128i *) rk;
+	__m128i s;
+	int r;
+
+	s = _mm_xor_si128(_mm_loadu_si128((const __m128i *) pt),
+			  _mm_loadu_si128(&k[0]));
+	for (r = 1; r < Nr; r++)
+		s = _mm_aesenc_si128(s, _mm_loadu_si128(&k[r]));
+	s = _mm_aesenclast_si128(s, _mm_loadu_si128(&k[Nr]));
+	_mm_storeu_si128((__m128i *) ct, s);
+}
+#endif /* AES_ACCEL_X86 */
+
+
 static void rijndaelEncrypt(const u32 rk[], int Nr, const u8 pt[16], u8 ct[16])
 {
 	u32 s0, s1, s2, s3, t0, t1, t2, t3;
@@ -112,6 +146,17 @@ void * aes_encrypt_init(const u8 *key, size_t len)
 		return NULL;
 	}
 	rk[AES_PRIV_NR_POS] = res;
+#ifdef AES_ACCEL_X86
+	if (aes_ni_available()) {
+		int i;
+
+		for (i = 0; i < 4 * (res + 1); i++) {
+			u32 val = rk[i];
+
+			PUTU32((u8 *) &rk[i], val);
+		}
+	}
+#endif /* AES_ACCEL_X86 */
 	return rk;
 }
 
@@ -119,6 +164,12 @@ void * aes_encrypt_init(const u8 *key, size_t len)
 int aes_encrypt(void *ctx, const u8 *plain, u8 *crypt)
 {
 	u32 *rk = ctx;
+#ifdef AES_ACCEL_X86
+	if (aes_ni > 0) {
+		aes_ni_encrypt(ctx, rk[AES_PRIV_NR_POS], plain, crypt);
+		return 0;
+	}
+#endif /* AES_ACCEL_X86 */
 	rijndaelEncrypt(ctx, rk[AES_PRIV_NR_POS], plain, crypt);
 	return 0;
 }
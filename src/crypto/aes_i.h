@@ -122,4 +122,38 @@ static inline u32 rotr(u32 val, int bits)
 
 int rijndaelKeySetupEnc(u32 rk[], const u8 cipherKey[], int keyBits);
 
+/*
+ * Set to 1 before the first AES/GCM operation to use the portable C
+ * implementation even if the CPU supports AES-NI and PCLMULQDQ. This is used
+ * by tests/test-aes to verify both code paths on the same host.
+ */
+extern int aes_accel_disabled;
+
+/*
+ * AES-NI and PCLMULQDQ code paths are selected at runtime based on CPUID. The
+ * compiler needs to support the target function attribute for building them
+ * without changing the CFLAGS of the whole build. Define CONFIG_NO_AES_ACCEL
+ * to use only the portable C implementation.
+ */
+#if !defined(CONFIG_NO_AES_ACCEL) && \
+	(defined(__x86_64__) || defined(__i386__)) && \
+	(defined(__clang__) || __GNUC__ > 4 || \
+	 (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define AES_ACCEL_X86
+#include <cpuid.h>
+
+#define AES_X86_CPUID_SSSE3 BIT(9)
+#define AES_X86_CPUID_PCLMULQDQ BIT(1)
+#define AES_X86_CPUID_AES BIT(25)
+
+static inline int aes_x86_cpu_has(unsigned int ecx_bits)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if (aes_accel_disabled || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return 0;
+	return (ecx & ecx_bits) == ecx_bits;
+}
+#endif /* AES_ACCEL_X86 */
+
 #endif /* AES_I_H */
@@ -10,6 +10,124 @@
 
 #include "common.h"
 #include "sha1.h"
+#ifdef CONFIG_CRYPTO_INTERNAL
+#include "sha1_i.h"
+#endif /* CONFIG_CRYPTO_INTERNAL */
+
+
+#ifdef CONFIG_CRYPTO_INTERNAL
+
+/*
+ * With the internal SHA-1 implementation, the HMAC key (passphrase) is
+ * processed only once: the SHA-1 states after the inner and outer pads are
+ * stored and each of the remaining PBKDF2 iterations takes exactly two
+ * SHA-1 compression function calls on a preformatted block. Independent
+ * output blocks (e.g., the two blocks needed for a 256-bit PSK) are
+ * interleaved in the same loop to allow the CPU to overlap the otherwise
+ * serial dependency chains.
+ */
+
+#define PBKDF2_SHA1_LANES 2
+
+struct pbkdf2_sha1_hmac {
+	struct SHA1Context ictx;
+	struct SHA1Context octx;
+};
+
+
+static void pbkdf2_sha1_hmac_init(struct pbkdf2_sha1_hmac *hmac,
+				  const u8 *key, size_t key_len)
+{
+	u8 tk[SHA1_MAC_LEN];
+	u8 pad[64];
+	size_t i;
+
+	if (key_len > sizeof(pad)) {
+		SHA1Init(&hmac->ictx);
+		SHA1Update(&hmac->ictx, key, key_len);
+		SHA1Final(tk, &hmac->ictx);
+		key = tk;
+		key_len = SHA1_MAC_LEN;
+	}
+
+	os_memset(pad, 0, sizeof(pad));
+	os_memcpy(pad, key, key_len);
+	for (i = 0; i < sizeof(pad); i++)
+		pad[i] ^= 0x36;
+	SHA1Init(&hmac->ictx);
+	SHA1Update(&hmac->ictx, pad, sizeof(pad));
+
+	for (i = 0; i < sizeof(pad); i++)
+		pad[i] ^= 0x36 ^ 0x5c;
+	SHA1Init(&hmac->octx);
+	SHA1Update(&hmac->octx, pad, sizeof(pad));
+
+	forced_memzero(pad, sizeof(pad));
+	forced_memzero(tk, sizeof(tk));
+}
+
+
+static void pbkdf2_sha1_state_to_block(const u32 *state, u8 *block)
+{
+	int i;
+
+	for (i = 0; i < 5; i++)
+		WPA_PUT_BE32(&block[4 * i], state[i]);
+}
+
+
+static void pbkdf2_sha1_blocks(const struct pbkdf2_sha1_hmac *hmac,
+			       const u8 *ssid, size_t ssid_len, int iterations,
+			       unsigned int count, unsigned int lanes,
+			       u8 digest[][SHA1_MAC_LEN])
+{
+	u8 block[PBKDF2_SHA1_LANES][64];
+	u32 state[5];
+	struct SHA1Context ctx;
+	unsigned int l;
+	u8 count_buf[4];
+	int i, j;
+
+	for (l = 0; l < lanes; l++) {
+		/* U1 = PRF(P, S || i) */
+		WPA_PUT_BE32(count_buf, count + l);
+		ctx = hmac->ictx;
+		SHA1Update(&ctx, ssid, ssid_len);
+		SHA1Update(&ctx, count_buf, sizeof(count_buf));
+		SHA1Final(block[l], &ctx);
+		ctx = hmac->octx;
+		SHA1Update(&ctx, block[l], SHA1_MAC_LEN);
+		SHA1Final(block[l], &ctx);
+		os_memcpy(digest[l], block[l], SHA1_MAC_LEN);
+
+		/*
+		 * SHA-1 padding for a 20 octet message following the 64 octet
+		 * HMAC pad block: 0x80, zeros, and the length in bits.
+		 */
+		os_memset(&block[l][SHA1_MAC_LEN], 0, 64 - SHA1_MAC_LEN);
+		block[l][SHA1_MAC_LEN] = 0x80;
+		WPA_PUT_BE16(&block[l][62], (64 + SHA1_MAC_LEN) * 8);
+	}
+
+	for (i = 1; i < iterations; i++) {
+		for (l = 0; l < lanes; l++) {
+			os_memcpy(state, hmac->ictx.state, sizeof(state));
+			SHA1Transform(state, block[l]);
+			pbkdf2_sha1_state_to_block(state, block[l]);
+			os_memcpy(state, hmac->octx.state, sizeof(state));
+			SHA1Transform(state, block[l]);
+			pbkdf2_sha1_state_to_block(state, block[l]);
+			for (j = 0; j < SHA1_MAC_LEN; j++)
+				digest[l][j] ^= block[l][j];
+		}
+	}
+
+	forced_memzero(block, sizeof(block));
+	forced_memzero(state, sizeof(state));
+	forced_memzero(&ctx, sizeof(ctx));
+}
+
+#else /* CONFIG_CRYPTO_INTERNAL */
 
 static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid,
 			 size_t ssid_len, int iterations, unsigned int count,
@@ -54,6 +172,8 @@ static int pbkdf2_sha1_f(const char *passphrase, const u8 *ssid,
 	return 0;
 }
 
+#endif /* CONFIG_CRYPTO_INTERNAL */
+
 
 /**
  * pbkdf2_sha1 - SHA1-based key derivation function (PBKDF2) for IEEE 802.11i
@@ -75,6 +195,34 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 	unsigned int count = 0;
 	unsigned char *pos = buf;
 	size_t left = buflen, plen;
+#ifdef CONFIG_CRYPTO_INTERNAL
+	struct pbkdf2_sha1_hmac hmac;
+	u8 digest[PBKDF2_SHA1_LANES][SHA1_MAC_LEN];
+	unsigned int l, lanes;
+
+	if (TEST_FAIL())
+		return -1;
+
+	pbkdf2_sha1_hmac_init(&hmac, (const u8 *) passphrase,
+			      os_strlen(passphrase));
+	while (left > 0) {
+		lanes = (left + SHA1_MAC_LEN - 1) / SHA1_MAC_LEN;
+		if (lanes > PBKDF2_SHA1_LANES)
+			lanes = PBKDF2_SHA1_LANES;
+		pbkdf2_sha1_blocks(&hmac, ssid, ssid_len, iterations,
+				   count + 1, lanes, digest);
+		count += lanes;
+		for (l = 0; l < lanes; l++) {
+			plen = left > SHA1_MAC_LEN ? SHA1_MAC_LEN : left;
+			os_memcpy(pos, digest[l], plen);
+			pos += plen;
+			left -= plen;
+		}
+	}
+
+	forced_memzero(&hmac, sizeof(hmac));
+	forced_memzero(digest, sizeof(digest));
+#else /* CONFIG_CRYPTO_INTERNAL */
 	unsigned char digest[SHA1_MAC_LEN];
 
 	while (left > 0) {
@@ -87,6 +235,7 @@ int pbkdf2_sha1(const char *passphrase, const u8 *ssid, size_t ssid_len,
 		pos += plen;
 		left -= plen;
 	}
+#endif /* CONFIG_CRYPTO_INTERNAL */
 
 	return 0;
 }
@@ -86,6 +86,8 @@ struct tls_config {
 	int cert_in_cb;
 	const char *openssl_ciphers;
 	unsigned int tls_session_lifetime;
+	unsigned int tls_session_cache_size;
+	const char *tls_session_cache_file;
 	unsigned int crl_reload_interval;
 	unsigned int tls_flags;
 
@@ -7,6 +7,8 @@
  */
 
 #include "includes.h"
+#include <sys/stat.h>
+#include <fcntl.h>
 
 #ifndef CONFIG_SMARTCARD
 #ifndef OPENSSL_NO_ENGINE
@@ -221,6 +223,10 @@ static struct tls_context *tls_global = NULL;
 struct tls_data {
 	SSL_CTX *ssl;
 	unsigned int tls_session_lifetime;
+	char *tls_session_cache_file;
+	struct tls_data *tls_session_cache_next;
+	u8 tls_session_cache_hash[SHA256_MAC_LEN];
+	int tls_session_cache_ready;
 	int check_crl;
 	int check_crl_strict;
 	char *ca_cert;
@@ -949,6 +955,355 @@ static void remove_session_cb(SSL_CTX *ctx, SSL_SESSION *sess)
 }
 
 
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L && \
+	!defined(LIBRESSL_VERSION_NUMBER) && !defined(OPENSSL_IS_BORINGSSL)
+
+#define TLS_SESSION_CACHE_MAGIC "hostapd TLS session cache v2\n"
+#define TLS_SESSION_CACHE_MAX_ITEM 65535
+
+IMPLEMENT_LHASH_DOALL_ARG(SSL_SESSION, FILE);
+
+
+static void tls_session_cache_hash_item(struct wpabuf **buf, const void *item,
+					size_t len)
+{
+	if (!*buf)
+		return;
+	if (wpabuf_resize(buf, 4 + len) < 0) {
+		wpabuf_clear_free(*buf);
+		*buf = NULL;
+		return;
+	}
+	wpabuf_put_be32(*buf, len);
+	if (len)
+		wpabuf_put_data(*buf, item, len);
+}
+
+
+static void tls_session_cache_hash_str(struct wpabuf **buf, const char *str)
+{
+	tls_session_cache_hash_item(buf, str, str ? os_strlen(str) : 0);
+}
+
+
+static void tls_session_cache_hash_file(struct wpabuf **buf, const char *fname)
+{
+	char *data = NULL;
+	size_t len = 0;
+
+	tls_session_cache_hash_str(buf, fname);
+	if (fname)
+		data = os_readfile(fname, &len);
+	tls_session_cache_hash_item(buf, data, data ? len : 0);
+	os_free(data);
+}
+
+
+/*
+ * Hash of the TLS server configuration that the cached sessions were
+ * established with. Sessions restored from the file skip certificate
+ * processing, so they must not be used after the certificates, the CRLs
+ * (included in the ca_cert file), or other parameters have been changed.
+ */
+static int tls_session_cache_config_hash(
+	const struct tls_connection_params *params, u8 *hash)
+{
+	struct wpabuf *buf;
+	const u8 *addr[1];
+	size_t len[1];
+	int ret = -1;
+
+	buf = wpabuf_alloc(1000);
+	if (!buf)
+		return -1;
+
+	tls_session_cache_hash_file(&buf, params->ca_cert);
+	tls_session_cache_hash_str(&buf, params->ca_path);
+	tls_session_cache_hash_item(&buf, params->ca_cert_blob,
+				    params->ca_cert_blob_len);
+	tls_session_cache_hash_file(&buf, params->client_cert);
+	tls_session_cache_hash_item(&buf, params->client_cert_blob,
+				    params->client_cert_blob_len);
+	tls_session_cache_hash_file(&buf, params->client_cert2);
+	tls_session_cache_hash_str(&buf, params->private_key);
+	tls_session_cache_hash_str(&buf, params->private_key2);
+	tls_session_cache_hash_file(&buf, params->dh_file);
+	tls_session_cache_hash_item(&buf, params->dh_blob,
+				    params->dh_blob_len);
+	tls_session_cache_hash_str(&buf, params->openssl_ciphers);
+	tls_session_cache_hash_str(&buf, params->openssl_ecdh_curves);
+	tls_session_cache_hash_str(&buf, params->check_cert_subject);
+
+	if (buf) {
+		addr[0] = wpabuf_head(buf);
+		len[0] = wpabuf_len(buf);
+		ret = sha256_vector(1, addr, len, hash);
+	}
+	wpabuf_clear_free(buf);
+	return ret;
+}
+
+
+static int tls_session_cache_write_item(FILE *f, const void *buf, size_t len)
+{
+	u8 hdr[4];
+
+	WPA_PUT_BE32(hdr, len);
+	if (fwrite(hdr, sizeof(hdr), 1, f) != 1 ||
+	    (len && fwrite(buf, len, 1, f) != 1))
+		return -1;
+	return 0;
+}
+
+
+static u8 * tls_session_cache_read_item(FILE *f, size_t *len)
+{
+	u8 hdr[4], *buf;
+
+	if (fread(hdr, sizeof(hdr), 1, f) != 1)
+		return NULL;
+	*len = WPA_GET_BE32(hdr);
+	if (*len == 0 || *len > TLS_SESSION_CACHE_MAX_ITEM)
+		return NULL;
+	buf = os_malloc(*len);
+	if (buf && fread(buf, *len, 1, f) != 1) {
+		os_free(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+
+static void tls_session_cache_write_session(SSL_SESSION *sess, FILE *f)
+{
+	struct wpabuf *appl;
+	unsigned char *der = NULL;
+	int der_len;
+
+	/* Sessions without success data cannot be resumed by EAP methods */
+	appl = SSL_SESSION_get_ex_data(sess, tls_ex_idx_session);
+	if (!appl || wpabuf_len(appl) == 0)
+		return;
+
+	der_len = i2d_SSL_SESSION(sess, &der);
+	if (der_len <= 0)
+		return;
+	if (tls_session_cache_write_item(f, der, der_len) < 0 ||
+	    tls_session_cache_write_item(f, wpabuf_head(appl),
+					 wpabuf_len(appl)) < 0)
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Failed to write session cache entry");
+	OPENSSL_clear_free(der, der_len);
+}
+
+
+static void tls_session_cache_save(struct tls_data *data)
+{
+	const char *fname = data->tls_session_cache_file;
+	char *tmp;
+	size_t len;
+	int fd;
+	FILE *f;
+
+	if (tls_ex_idx_session < 0)
+		return;
+
+	/* Drop expired sessions before storing the remaining ones */
+	SSL_CTX_flush_sessions(data->ssl, time(NULL));
+
+	len = os_strlen(fname) + 5;
+	tmp = os_malloc(len);
+	if (!tmp)
+		return;
+	os_snprintf(tmp, len, "%s.tmp", fname);
+
+	/*
+	 * Do not reuse a leftover file since it could have been created with
+	 * less strict permissions.
+	 */
+	unlink(tmp);
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	f = fd >= 0 ? fdopen(fd, "wb") : NULL;
+	if (!f) {
+		wpa_printf(MSG_INFO, "OpenSSL: Could not create '%s': %s",
+			   tmp, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		os_free(tmp);
+		return;
+	}
+
+	fwrite(TLS_SESSION_CACHE_MAGIC, os_strlen(TLS_SESSION_CACHE_MAGIC), 1,
+	       f);
+	fwrite(data->tls_session_cache_hash, SHA256_MAC_LEN, 1, f);
+	lh_SSL_SESSION_doall_FILE(SSL_CTX_sessions(data->ssl),
+				  tls_session_cache_write_session, f);
+	if (fclose(f) != 0 || rename(tmp, fname) < 0) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Failed to write session cache file '%s': %s",
+			   fname, strerror(errno));
+		unlink(tmp);
+	} else {
+		wpa_printf(MSG_DEBUG,
+			   "OpenSSL: Stored TLS session cache into '%s'",
+			   fname);
+	}
+	os_free(tmp);
+}
+
+
+static void tls_session_cache_load(struct tls_data *data)
+{
+	const char *fname = data->tls_session_cache_file;
+	char magic[sizeof(TLS_SESSION_CACHE_MAGIC) - 1];
+	u8 hash[SHA256_MAC_LEN];
+	u8 *der, *appl;
+	size_t der_len, appl_len;
+	unsigned int count = 0;
+	time_t now = time(NULL);
+	FILE *f;
+
+	f = fopen(fname, "rb");
+	if (!f) {
+		wpa_printf(MSG_DEBUG,
+			   "OpenSSL: No TLS session cache file '%s' to load",
+			   fname);
+		return;
+	}
+
+	if (fread(magic, sizeof(magic), 1, f) != 1 ||
+	    os_memcmp(magic, TLS_SESSION_CACHE_MAGIC, sizeof(magic)) != 0) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Unrecognized TLS session cache file '%s'",
+			   fname);
+		fclose(f);
+		return;
+	}
+
+	if (fread(hash, sizeof(hash), 1, f) != 1 ||
+	    os_memcmp(hash, data->tls_session_cache_hash, sizeof(hash)) != 0) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: TLS configuration has changed - discard TLS session cache file '%s'",
+			   fname);
+		fclose(f);
+		return;
+	}
+
+	while ((der = tls_session_cache_read_item(f, &der_len))) {
+		const unsigned char *pos = der;
+		SSL_SESSION *sess;
+		struct wpabuf *buf;
+
+		appl = tls_session_cache_read_item(f, &appl_len);
+		sess = d2i_SSL_SESSION(NULL, &pos, der_len);
+		bin_clear_free(der, der_len);
+		if (!appl || !sess) {
+			os_free(appl);
+			SSL_SESSION_free(sess);
+			break;
+		}
+
+		buf = wpabuf_alloc_ext_data(appl, appl_len);
+		if (!buf) {
+			os_free(appl);
+			SSL_SESSION_free(sess);
+			break;
+		}
+
+		if ((time_t) (SSL_SESSION_get_time(sess) +
+			      SSL_SESSION_get_timeout(sess)) <= now ||
+		    SSL_SESSION_set_ex_data(sess, tls_ex_idx_session,
+					    buf) != 1) {
+			wpabuf_free(buf);
+		} else if (SSL_CTX_add_session(data->ssl, sess) != 1) {
+			SSL_SESSION_set_ex_data(sess, tls_ex_idx_session, NULL);
+			wpabuf_free(buf);
+		} else {
+			count++;
+		}
+		SSL_SESSION_free(sess);
+	}
+
+	fclose(f);
+	wpa_printf(MSG_DEBUG,
+		   "OpenSSL: Loaded %u TLS session(s) from session cache file '%s'",
+		   count, fname);
+}
+
+#else /* OpenSSL 1.1.0 or newer */
+
+static int tls_session_cache_config_hash(
+	const struct tls_connection_params *params, u8 *hash)
+{
+	return 0;
+}
+
+
+static void tls_session_cache_save(struct tls_data *data)
+{
+}
+
+
+static void tls_session_cache_load(struct tls_data *data)
+{
+	wpa_printf(MSG_INFO,
+		   "OpenSSL: TLS session cache file not supported with this TLS library version");
+}
+
+#endif /* OpenSSL 1.1.0 or newer */
+
+
+/* TLS contexts that use a session cache file */
+static struct tls_data *tls_session_cache_users = NULL;
+
+static int tls_session_cache_file_in_use(const char *fname)
+{
+	struct tls_data *data;
+
+	for (data = tls_session_cache_users; data;
+	     data = data->tls_session_cache_next) {
+		if (os_strcmp(data->tls_session_cache_file, fname) == 0)
+			return 1;
+	}
+	return 0;
+}
+
+
+static void tls_session_cache_user_del(struct tls_data *data)
+{
+	struct tls_data **pos;
+
+	for (pos = &tls_session_cache_users; *pos;
+	     pos = &(*pos)->tls_session_cache_next) {
+		if (*pos == data) {
+			*pos = data->tls_session_cache_next;
+			break;
+		}
+	}
+}
+
+
+static void tls_session_cache_set_params(
+	struct tls_data *data, const struct tls_connection_params *params)
+{
+	if (!data->tls_session_cache_file)
+		return;
+
+	if (tls_session_cache_config_hash(params,
+					  data->tls_session_cache_hash) < 0) {
+		wpa_printf(MSG_INFO,
+			   "OpenSSL: Could not hash TLS configuration - TLS session cache file not used");
+		data->tls_session_cache_ready = 0;
+		return;
+	}
+
+	/* Load the stored sessions only once for the initial configuration */
+	if (!data->tls_session_cache_ready)
+		tls_session_cache_load(data);
+	data->tls_session_cache_ready = 1;
+}
+
+
 void * tls_init(const struct tls_config *conf)
 {
 	struct tls_data *data;
@@ -1065,6 +1420,9 @@ void * tls_init(const struct tls_config *conf)
 		SSL_CTX_set_session_cache_mode(ssl, SSL_SESS_CACHE_SERVER);
 		SSL_CTX_set_timeout(ssl, data->tls_session_lifetime);
 		SSL_CTX_sess_set_remove_cb(ssl, remove_session_cb);
+		if (conf->tls_session_cache_size)
+			SSL_CTX_sess_set_cache_size(
+				ssl, conf->tls_session_cache_size);
 	} else {
 		SSL_CTX_set_session_cache_mode(ssl, SSL_SESS_CACHE_OFF);
 	}
@@ -1078,6 +1436,24 @@ void * tls_init(const struct tls_config *conf)
 		}
 	}
 
+	if (data->tls_session_lifetime > 0 && conf &&
+	    conf->tls_session_cache_file) {
+		if (tls_session_cache_file_in_use(
+			    conf->tls_session_cache_file)) {
+			wpa_printf(MSG_ERROR,
+				   "OpenSSL: TLS session cache file '%s' is already used by another TLS context",
+				   conf->tls_session_cache_file);
+			tls_deinit(data);
+			return NULL;
+		}
+		data->tls_session_cache_file =
+			os_strdup(conf->tls_session_cache_file);
+		if (data->tls_session_cache_file) {
+			data->tls_session_cache_next = tls_session_cache_users;
+			tls_session_cache_users = data;
+		}
+	}
+
 #ifndef OPENSSL_NO_ENGINE
 	wpa_printf(MSG_DEBUG, "ENGINE: Loading builtin engines");
 	ENGINE_load_builtin_engines();
@@ -1117,6 +1493,12 @@ void tls_deinit(void *ssl_ctx)
 	struct tls_context *context = SSL_CTX_get_app_data(ssl);
 	if (context != tls_global)
 		os_free(context);
+	if (data->tls_session_cache_file) {
+		if (data->tls_session_cache_ready)
+			tls_session_cache_save(data);
+		tls_session_cache_user_del(data);
+		os_free(data->tls_session_cache_file);
+	}
 	if (data->tls_session_lifetime > 0)
 		SSL_CTX_flush_sessions(ssl, 0);
 	os_free(data->ca_cert);
@@ -5482,6 +5864,8 @@ int tls_global_set_params(void *tls_ctx,
 
 	openssl_debug_dump_ctx(ssl_ctx);
 
+	tls_session_cache_set_params(data, params);
+
 	return 0;
 }
 
@@ -335,6 +335,8 @@ struct hostapd_hw_modes {
  * @est_throughput: Estimated throughput in kbps (this is calculated during
  * scan result processing if left zero by the driver wrapper)
  * @snr: Signal-to-noise ratio in dB (calculated during scan result processing)
+ * @wpa: Whether the BSS advertises a WPA or RSN element (calculated during scan
+ * result processing to avoid parsing the IEs for each comparison when sorting)
  * @parent_tsf: Time when the Beacon/Probe Response frame was received in terms
  * of TSF of the BSS specified by %tsf_bssid.
  * @tsf_bssid: The BSS that %parent_tsf TSF time refers to.
@@ -368,6 +370,7 @@ struct wpa_scan_res {
 	unsigned int age;
 	unsigned int est_throughput;
 	int snr;
+	bool wpa;
 	u64 parent_tsf;
 	u8 tsf_bssid[ETH_ALEN];
 	size_t ie_len;
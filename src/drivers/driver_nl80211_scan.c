@@ -831,6 +831,7 @@ nl80211_parse_bss_info(struct wpa_driver_nl80211_data *drv,
 struct nl80211_bss_info_arg {
 	struct wpa_driver_nl80211_data *drv;
 	struct wpa_scan_results *res;
+	size_t res_size; /* allocated entries in res->res */
 };
 
 static int bss_info_handler(struct nl_msg *msg, void *arg)
@@ -848,14 +849,19 @@ static int bss_info_handler(struct nl_msg *msg, void *arg)
 		os_free(r);
 		return NL_SKIP;
 	}
-	tmp = os_realloc_array(res->res, res->num + 1,
-			       sizeof(struct wpa_scan_res *));
-	if (tmp == NULL) {
-		os_free(r);
-		return NL_SKIP;
+	if (res->num == _arg->res_size) {
+		size_t size = _arg->res_size ? 2 * _arg->res_size : 32;
+
+		tmp = os_realloc_array(res->res, size,
+				       sizeof(struct wpa_scan_res *));
+		if (tmp == NULL) {
+			os_free(r);
+			return NL_SKIP;
+		}
+		res->res = tmp;
+		_arg->res_size = size;
 	}
-	tmp[res->num++] = r;
-	res->res = tmp;
+	res->res[res->num++] = r;
 
 	return NL_SKIP;
 }
@@ -945,6 +951,7 @@ try_again:
 
 	arg.drv = drv;
 	arg.res = res;
+	arg.res_size = 0;
 	ret = send_and_recv_msgs(drv, msg, bss_info_handler, &arg, NULL, NULL);
 	if (ret == -EAGAIN) {
 		count++;
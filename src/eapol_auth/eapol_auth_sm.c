@@ -17,6 +17,9 @@
 #include "eap_server/eap.h"
 #include "eapol_auth_sm.h"
 #include "eapol_auth_sm_i.h"
+#ifdef CONFIG_LATENCY_STATS
+#include "utils/latency_hist.h"
+#endif /* CONFIG_LATENCY_STATS */
 
 #define STATE_MACHINE_DATA struct eapol_state_machine
 #define STATE_MACHINE_DEBUG_PREFIX "IEEE 802.1X"
@@ -911,6 +914,10 @@ static void eapol_sm_step_run(struct eapol_state_machine *sm)
 	unsigned int prev_auth_pae, prev_be_auth, prev_reauth_timer,
 		prev_auth_key_tx, prev_key_rx, prev_ctrl_dir;
 	int max_steps = 100;
+	int changed;
+#ifdef CONFIG_LATENCY_STATS
+	struct os_reltime step_start;
+#endif /* CONFIG_LATENCY_STATS */
 
 	os_memcpy(addr, sm->addr, ETH_ALEN);
 
@@ -956,7 +963,16 @@ restart:
 	}
 
 	if (eapol_sm_sta_entry_alive(eapol, addr) && sm->eap) {
-		if (eap_server_sm_step(sm->eap)) {
+#ifdef CONFIG_LATENCY_STATS
+		os_get_reltime(&step_start);
+#endif /* CONFIG_LATENCY_STATS */
+		changed = eap_server_sm_step(sm->eap);
+#ifdef CONFIG_LATENCY_STATS
+		if (changed && eapol->conf.eap_step_hist)
+			latency_hist_add_since(eapol->conf.eap_step_hist,
+					       &step_start);
+#endif /* CONFIG_LATENCY_STATS */
+		if (changed) {
 			if (--max_steps > 0)
 				goto restart;
 			/* Re-run from eloop timeout */
@@ -1216,6 +1232,9 @@ static int eapol_auth_conf_clone(struct eapol_auth_config *dst,
 		dst->erp_domain = NULL;
 	}
 	dst->erp_send_reauth_start = src->erp_send_reauth_start;
+#ifdef CONFIG_LATENCY_STATS
+	dst->eap_step_hist = src->eap_step_hist;
+#endif /* CONFIG_LATENCY_STATS */
 
 	return 0;
 
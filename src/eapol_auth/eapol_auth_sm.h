@@ -27,6 +27,9 @@ struct eapol_auth_config {
 	size_t eap_req_id_text_len;
 	int erp_send_reauth_start;
 	char *erp_domain; /* a copy of this will be allocated */
+#ifdef CONFIG_LATENCY_STATS
+	struct latency_hist *eap_step_hist; /* EAP server step times */
+#endif /* CONFIG_LATENCY_STATS */
 
 	/* Opaque context pointer to owner data for callback functions */
 	void *ctx;
@@ -23,6 +23,13 @@
 
 /**
  * RADIUS_CLIENT_FIRST_WAIT - RADIUS client timeout for first retry in seconds
+ *
+ * This is used until a round-trip time has been measured for the server. It
+ * is also the lower bound for the retransmission timeout derived from the
+ * measured round-trip time: the response time includes back-end processing
+ * (e.g., user database or proxy lookups) that can vary widely between
+ * requests, so a fast typical response must not lead to early duplicates
+ * and failover.
  */
 #define RADIUS_CLIENT_FIRST_WAIT 3
 
@@ -261,6 +268,75 @@ static void radius_client_auth_failover(struct radius_client_data *radius);
 static void radius_client_acct_failover(struct radius_client_data *radius);
 
 
+/*
+ * Retransmission timeout (in seconds) for a server based on the smoothed
+ * round-trip time and its variation as described in RFC 6298.
+ */
+static int radius_client_rto(const struct hostapd_radius_server *serv)
+{
+	unsigned long rto;
+
+	if (!serv || !serv->srtt)
+		return RADIUS_CLIENT_FIRST_WAIT;
+
+	rto = serv->srtt + 4UL * serv->rttvar;
+	rto = (rto + 999999) / 1000000;
+	if (rto < RADIUS_CLIENT_FIRST_WAIT)
+		rto = RADIUS_CLIENT_FIRST_WAIT;
+	if (rto > RADIUS_CLIENT_MAX_WAIT)
+		rto = RADIUS_CLIENT_MAX_WAIT;
+	return rto;
+}
+
+
+/*
+ * Time for the next transmission attempt at least wait seconds after a
+ * transmission at time sent. The retransmit list has whole second granularity,
+ * so round up to keep the full timeout for a message sent late in a second.
+ */
+static os_time_t radius_client_next_try(const struct os_reltime *sent,
+					int wait)
+{
+	return sent->sec + wait + (sent->usec ? 1 : 0);
+}
+
+
+static void radius_client_update_rtt(struct hostapd_radius_server *serv,
+				     struct radius_msg_list *req,
+				     struct os_reltime *now)
+{
+	struct os_reltime diff;
+	u32 rtt, delta;
+
+	/* Karn's algorithm: the response to a retransmitted request cannot be
+	 * matched to a specific transmission, so it is not used as a sample.
+	 */
+	if (req->attempts != 1)
+		return;
+
+	os_reltime_sub(now, &req->last_attempt, &diff);
+	if (diff.sec < 0)
+		return;
+	if (diff.sec >= RADIUS_CLIENT_MAX_WAIT)
+		rtt = RADIUS_CLIENT_MAX_WAIT * 1000000;
+	else
+		rtt = diff.sec * 1000000 + diff.usec;
+	if (!rtt)
+		rtt = 1;
+
+	if (!serv->srtt) {
+		serv->srtt = rtt;
+		serv->rttvar = rtt / 2;
+	} else {
+		delta = serv->srtt > rtt ? serv->srtt - rtt : rtt - serv->srtt;
+		serv->rttvar = serv->rttvar - serv->rttvar / 4 + delta / 4;
+		serv->srtt = serv->srtt - serv->srtt / 8 + rtt / 8;
+		if (!serv->srtt)
+			serv->srtt = 1;
+	}
+}
+
+
 static void radius_client_msg_free(struct radius_msg_list *req)
 {
 	radius_msg_free(req->msg);
@@ -484,7 +560,8 @@ static int radius_client_retransmit(struct radius_client_data *radius,
 			return 0;
 	}
 
-	entry->next_try = now + entry->next_wait;
+	entry->next_try = radius_client_next_try(&entry->last_attempt,
+						 entry->next_wait);
 	entry->next_wait *= 2;
 	if (entry->next_wait > RADIUS_CLIENT_MAX_WAIT)
 		entry->next_wait = RADIUS_CLIENT_MAX_WAIT;
@@ -675,6 +752,7 @@ static void radius_client_list_add(struct radius_client_data *radius,
 				   size_t shared_secret_len, const u8 *addr)
 {
 	struct radius_msg_list *entry, *prev;
+	int rto;
 #ifdef CONFIG_SONIC_RADIUS
 	struct radius_hdr *hdr;
 #endif
@@ -700,10 +778,13 @@ static void radius_client_list_add(struct radius_client_data *radius,
 	entry->shared_secret_len = shared_secret_len;
 	os_get_reltime(&entry->last_attempt);
 	entry->first_try = entry->last_attempt.sec;
-	entry->next_try = entry->first_try + RADIUS_CLIENT_FIRST_WAIT;
+	rto = radius_client_rto(msg_type == RADIUS_AUTH ?
+				radius->conf->auth_server :
+				radius->conf->acct_server);
+	entry->next_try = radius_client_next_try(&entry->last_attempt, rto);
 	entry->attempts = 1;
 	entry->accu_attempts = 1;
-	entry->next_wait = RADIUS_CLIENT_FIRST_WAIT * 2;
+	entry->next_wait = rto * 2;
 	if (entry->next_wait > RADIUS_CLIENT_MAX_WAIT)
 		entry->next_wait = RADIUS_CLIENT_MAX_WAIT;
 	entry->next = radius->msgs;
@@ -941,6 +1022,10 @@ static void radius_client_receive(int sock, void *eloop_ctx, void *sock_ctx)
 		       roundtrip / 100, roundtrip % 100);
 #endif
 	rconf->round_trip_time = roundtrip;
+	radius_client_update_rtt(rconf, req, &now);
+#ifdef CONFIG_LATENCY_STATS
+	latency_hist_add_since(&rconf->rtt_hist, &req->last_attempt);
+#endif /* CONFIG_LATENCY_STATS */
 
 	/* Remove ACKed RADIUS packet from retransmit list */
 	if (prev_req)
@@ -1073,6 +1158,10 @@ void radius_client_receive_proces(void *cxt,
 		       msg_type, hdr->identifier,
 		       roundtrip / 100, roundtrip % 100);
 	rconf->round_trip_time = roundtrip;
+	radius_client_update_rtt(rconf, req, &now);
+#ifdef CONFIG_LATENCY_STATS
+	latency_hist_add_since(&rconf->rtt_hist, &req->last_attempt);
+#endif /* CONFIG_LATENCY_STATS */
 
 	/* Remove ACKed RADIUS packet from retransmit list */
 	if (prev_req)
@@ -1272,7 +1361,7 @@ radius_change_server(struct radius_client_data *radius,
 	struct sockaddr *addr, *cl_addr;
 	socklen_t addrlen, claddrlen;
 	char abuf[50];
-	int sel_sock;
+	int sel_sock, rto;
 	struct radius_msg_list *entry;
 	struct hostapd_radius_servers *conf = radius->conf;
 	struct sockaddr_in disconnect_addr = {
@@ -1324,19 +1413,21 @@ radius_change_server(struct radius_client_data *radius,
 	}
 
 	/* Reset retry counters */
+	rto = radius_client_rto(nserv);
 	for (entry = radius->msgs; oserv && entry; entry = entry->next) {
 		if ((auth && entry->msg_type != RADIUS_AUTH) ||
 		    (!auth && entry->msg_type != RADIUS_ACCT))
 			continue;
-		entry->next_try = entry->first_try + RADIUS_CLIENT_FIRST_WAIT;
+		/* first_try is truncated to whole seconds */
+		entry->next_try = entry->first_try + rto + 1;
 		entry->attempts = 0;
-		entry->next_wait = RADIUS_CLIENT_FIRST_WAIT * 2;
+		entry->next_wait = rto * 2;
 	}
 
 	if (radius->msgs) {
 		eloop_cancel_timeout(radius_client_timer, radius, NULL);
-		eloop_register_timeout(RADIUS_CLIENT_FIRST_WAIT, 0,
-				       radius_client_timer, radius, NULL);
+		eloop_register_timeout(rto, 0, radius_client_timer, radius,
+				       NULL);
 	}
 
 	switch (nserv->addr.af) {
@@ -1802,7 +1893,10 @@ static int radius_client_dump_auth_server(char *buf, size_t buflen,
 			   "radiusAuthClientPendingRequests=%u\n"
 			   "radiusAuthClientTimeouts=%u\n"
 			   "radiusAuthClientUnknownTypes=%u\n"
-			   "radiusAuthClientPacketsDropped=%u\n",
+			   "radiusAuthClientPacketsDropped=%u\n"
+			   "radiusAuthClientSmoothedRoundTripTime=%u\n"
+			   "radiusAuthClientRoundTripTimeVariation=%u\n"
+			   "radiusAuthClientRetransmissionTimeout=%d\n",
 			   serv->index,
 			   hostapd_ip_txt(&serv->addr, abuf, sizeof(abuf)),
 			   serv->port,
@@ -1817,7 +1911,8 @@ static int radius_client_dump_auth_server(char *buf, size_t buflen,
 			   pending,
 			   serv->timeouts,
 			   serv->unknown_types,
-			   serv->packets_dropped);
+			   serv->packets_dropped,
+			   serv->srtt, serv->rttvar, radius_client_rto(serv));
 }
 
 
@@ -1850,7 +1945,10 @@ static int radius_client_dump_acct_server(char *buf, size_t buflen,
 			   "radiusAccClientPendingRequests=%u\n"
 			   "radiusAccClientTimeouts=%u\n"
 			   "radiusAccClientUnknownTypes=%u\n"
-			   "radiusAccClientPacketsDropped=%u\n",
+			   "radiusAccClientPacketsDropped=%u\n"
+			   "radiusAccClientSmoothedRoundTripTime=%u\n"
+			   "radiusAccClientRoundTripTimeVariation=%u\n"
+			   "radiusAccClientRetransmissionTimeout=%d\n",
 			   serv->index,
 			   hostapd_ip_txt(&serv->addr, abuf, sizeof(abuf)),
 			   serv->port,
@@ -1863,7 +1961,8 @@ static int radius_client_dump_acct_server(char *buf, size_t buflen,
 			   pending,
 			   serv->timeouts,
 			   serv->unknown_types,
-			   serv->packets_dropped);
+			   serv->packets_dropped,
+			   serv->srtt, serv->rttvar, radius_client_rto(serv));
 }
 
 
@@ -10,6 +10,9 @@
 #define RADIUS_CLIENT_H
 
 #include "ip_addr.h"
+#ifdef CONFIG_LATENCY_STATS
+#include "utils/latency_hist.h"
+#endif /* CONFIG_LATENCY_STATS */
 
 struct radius_msg;
 
@@ -58,6 +61,17 @@ struct hostapd_radius_server {
 	 */
 	int round_trip_time;
 
+	/**
+	 * srtt - Smoothed round-trip time in microseconds (RFC 6298)
+	 * 0 if no round-trip time has been measured.
+	 */
+	unsigned int srtt;
+
+	/**
+	 * rttvar - Round-trip time variation in microseconds (RFC 6298)
+	 */
+	unsigned int rttvar;
+
 	/**
 	 * requests - radiusAuthClientAccessRequests or radiusAccClientRequests
 	 */
@@ -112,6 +126,13 @@ struct hostapd_radius_server {
 	 * packets_dropped - radiusAuthClientPacketsDropped or radiusAccClientPacketsDropped
 	 */
 	u32 packets_dropped;
+
+#ifdef CONFIG_LATENCY_STATS
+	/**
+	 * rtt_hist - Round-trip time histogram (usec)
+	 */
+	struct latency_hist rtt_hist;
+#endif /* CONFIG_LATENCY_STATS */
 };
 
 /**
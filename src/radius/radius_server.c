@@ -40,6 +40,17 @@
  */
 #define RADIUS_MAX_MSG_LEN 3000
 
+/**
+ * RADIUS_SESSION_HASH_SIZE - Number of buckets in the session hash table
+ */
+#define RADIUS_SESSION_HASH_SIZE 256
+#define RADIUS_SESSION_HASH(id) ((id) & (RADIUS_SESSION_HASH_SIZE - 1))
+
+/**
+ * RADIUS_CLIENT_HASH_SIZE - Number of buckets in the client address hash
+ */
+#define RADIUS_CLIENT_HASH_SIZE 256
+
 static const struct eapol_callbacks radius_server_eapol_cb;
 
 struct radius_client;
@@ -73,6 +84,7 @@ struct radius_server_counters {
  */
 struct radius_session {
 	struct radius_session *next;
+	struct radius_session *hnext; /* next entry in server sess_hash */
 	struct radius_client *client;
 	struct radius_server_data *server;
 	unsigned int sess_id;
@@ -105,6 +117,9 @@ struct radius_session {
  */
 struct radius_client {
 	struct radius_client *next;
+	struct radius_client *hnext; /* next entry in server client_hash */
+	struct radius_client *pnext; /* next entry in server prefix_clients */
+	unsigned int idx; /* position in the client file */
 	struct in_addr addr;
 	struct in_addr mask;
 #ifdef CONFIG_IPV6
@@ -144,6 +159,21 @@ struct radius_server_data {
 	 */
 	struct radius_client *clients;
 
+	/**
+	 * client_hash - Clients with a host address (full mask) by address
+	 */
+	struct radius_client *client_hash[RADIUS_CLIENT_HASH_SIZE];
+
+	/**
+	 * prefix_clients - Clients with a network prefix in client file order
+	 */
+	struct radius_client *prefix_clients;
+
+	/**
+	 * sess_hash - Active sessions of all clients by sess_id
+	 */
+	struct radius_session *sess_hash[RADIUS_SESSION_HASH_SIZE];
+
 	/**
 	 * next_sess_id - Next session identifier
 	 */
@@ -333,66 +363,173 @@ void srv_log(struct radius_session *sess, const char *fmt, ...)
 }
 
 
-static struct radius_client *
-radius_server_get_client(struct radius_server_data *data, struct in_addr *addr,
-			 int ipv6)
+static unsigned int radius_server_client_hash(const u8 *addr, size_t len)
 {
-	struct radius_client *client = data->clients;
+	unsigned int hash = 0;
 
-	while (client) {
+	while (len--)
+		hash = hash * 31 + *addr++;
+	return hash & (RADIUS_CLIENT_HASH_SIZE - 1);
+}
+
+
+static int radius_server_client_match(struct radius_client *client,
+				      struct in_addr *addr, int ipv6)
+{
 #ifdef CONFIG_IPV6
-		if (ipv6) {
-			struct in6_addr *addr6;
-			int i;
-
-			addr6 = (struct in6_addr *) addr;
-			for (i = 0; i < 16; i++) {
-				if ((addr6->s6_addr[i] &
-				     client->mask6.s6_addr[i]) !=
-				    (client->addr6.s6_addr[i] &
-				     client->mask6.s6_addr[i])) {
-					i = 17;
-					break;
-				}
-			}
-			if (i == 16) {
-				break;
-			}
+	if (ipv6) {
+		struct in6_addr *addr6;
+		int i;
+
+		addr6 = (struct in6_addr *) addr;
+		for (i = 0; i < 16; i++) {
+			if ((addr6->s6_addr[i] & client->mask6.s6_addr[i]) !=
+			    (client->addr6.s6_addr[i] &
+			     client->mask6.s6_addr[i]))
+				return 0;
 		}
+		return 1;
+	}
 #endif /* CONFIG_IPV6 */
-		if (!ipv6 && (client->addr.s_addr & client->mask.s_addr) ==
-		    (addr->s_addr & client->mask.s_addr)) {
-			break;
-		}
+	return !ipv6 && (client->addr.s_addr & client->mask.s_addr) ==
+		(addr->s_addr & client->mask.s_addr);
+}
 
-		client = client->next;
+
+static int radius_server_client_is_host(struct radius_client *client,
+					int ipv6)
+{
+#ifdef CONFIG_IPV6
+	if (ipv6) {
+		int i;
+
+		for (i = 0; i < 16; i++) {
+			if (client->mask6.s6_addr[i] != 0xff)
+				return 0;
+		}
+		return 1;
 	}
+#endif /* CONFIG_IPV6 */
+	return client->mask.s_addr == 0xffffffff;
+}
+
+
+static unsigned int radius_server_addr_hash(struct in_addr *addr, int ipv6)
+{
+#ifdef CONFIG_IPV6
+	if (ipv6)
+		return radius_server_client_hash(
+			((struct in6_addr *) addr)->s6_addr, 16);
+#endif /* CONFIG_IPV6 */
+	return radius_server_client_hash((u8 *) &addr->s_addr, 4);
+}
+
 
+static struct radius_client *
+radius_server_get_client_host(struct radius_server_data *data,
+			      struct in_addr *addr, int ipv6)
+{
+	struct radius_client *client;
+
+	client = data->client_hash[radius_server_addr_hash(addr, ipv6)];
+	while (client && !radius_server_client_match(client, addr, ipv6))
+		client = client->hnext;
 	return client;
 }
 
 
+static void radius_server_index_clients(struct radius_server_data *data)
+{
+	struct radius_client *client, *ptail = NULL;
+	struct in_addr *addr;
+	unsigned int idx = 0, hash;
+
+	for (client = data->clients; client; client = client->next) {
+		client->idx = idx++;
+		if (!radius_server_client_is_host(client, data->ipv6)) {
+			if (ptail)
+				ptail->pnext = client;
+			else
+				data->prefix_clients = client;
+			ptail = client;
+			continue;
+		}
+
+#ifdef CONFIG_IPV6
+		if (data->ipv6)
+			addr = (struct in_addr *) &client->addr6;
+		else
+#endif /* CONFIG_IPV6 */
+		addr = &client->addr;
+
+		/* Only the first entry for a duplicated address can match */
+		if (radius_server_get_client_host(data, addr, data->ipv6))
+			continue;
+		hash = radius_server_addr_hash(addr, data->ipv6);
+		client->hnext = data->client_hash[hash];
+		data->client_hash[hash] = client;
+	}
+}
+
+
+static struct radius_client *
+radius_server_get_client(struct radius_server_data *data, struct in_addr *addr,
+			 int ipv6)
+{
+	struct radius_client *client, *host;
+
+	/*
+	 * An exact host entry wins unless a network prefix entry that covers
+	 * the same address appears before it in the client file.
+	 */
+	host = radius_server_get_client_host(data, addr, ipv6);
+	for (client = data->prefix_clients; client; client = client->pnext) {
+		if (host && client->idx > host->idx)
+			break;
+		if (radius_server_client_match(client, addr, ipv6))
+			return client;
+	}
+
+	return host;
+}
+
+
 static struct radius_session *
-radius_server_get_session(struct radius_client *client, unsigned int sess_id)
+radius_server_get_session(struct radius_server_data *data,
+			  struct radius_client *client, unsigned int sess_id)
 {
-	struct radius_session *sess = client->sessions;
+	struct radius_session *sess;
 
+	sess = data->sess_hash[RADIUS_SESSION_HASH(sess_id)];
 	while (sess) {
-		if (sess->sess_id == sess_id) {
+		if (sess->sess_id == sess_id && sess->client == client)
 			break;
-		}
-		sess = sess->next;
+		sess = sess->hnext;
 	}
 
 	return sess;
 }
 
 
+static void radius_server_sess_hash_del(struct radius_server_data *data,
+					struct radius_session *sess)
+{
+	struct radius_session **pos;
+
+	pos = &data->sess_hash[RADIUS_SESSION_HASH(sess->sess_id)];
+	while (*pos && *pos != sess)
+		pos = &(*pos)->hnext;
+	if (*pos)
+		*pos = sess->hnext;
+}
+
+
 static void radius_server_session_free(struct radius_server_data *data,
 				       struct radius_session *sess)
 {
 	eloop_cancel_timeout(radius_server_session_timeout, data, sess);
 	eloop_cancel_timeout(radius_server_session_remove_timeout, data, sess);
+	radius_server_sess_hash_del(data, sess);
 	eap_server_sm_deinit(sess->eap);
 	radius_msg_free(sess->last_msg);
 	os_free(sess->last_from_addr);
@@ -471,6 +608,8 @@ radius_server_new_session(struct radius_server_data *data,
 	sess->sess_id = data->next_sess_id++;
 	sess->next = client->sessions;
 	client->sessions = sess;
+	sess->hnext = data->sess_hash[RADIUS_SESSION_HASH(sess->sess_id)];
+	data->sess_hash[RADIUS_SESSION_HASH(sess->sess_id)] = sess;
 	eloop_register_timeout(RADIUS_SESSION_TIMEOUT, 0,
 			       radius_server_session_timeout, data, sess);
 	data->num_sess++;
@@ -1367,7 +1506,7 @@ static int radius_server_request(struct radius_server_data *data,
 		state_included = res >= 0;
 		if (res == sizeof(statebuf)) {
 			state = WPA_GET_BE32(statebuf);
-			sess = radius_server_get_session(client, state);
+			sess = radius_server_get_session(data, client, state);
 		} else {
 			sess = NULL;
 		}
@@ -2262,6 +2401,7 @@ radius_server_init(struct radius_server_conf *conf)
 		wpa_printf(MSG_ERROR, "No RADIUS clients configured");
 		goto fail;
 	}
+	radius_server_index_clients(data);
 
 #ifdef CONFIG_IPV6
 	if (conf->ipv6)
@@ -0,0 +1,132 @@
+/*
+ * Latency histograms
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#include "includes.h"
+
+#include "common.h"
+#include "latency_hist.h"
+
+
+#define SUB_BUCKETS (1 << LATENCY_HIST_SUB_BITS)
+
+
+static unsigned int latency_hist_index(u32 val)
+{
+	unsigned int msb = 0;
+	u32 tmp = val;
+
+	if (val < 2 * SUB_BUCKETS)
+		return val;
+
+	while (tmp >>= 1)
+		msb++;
+
+	/* msb >= LATENCY_HIST_SUB_BITS + 1 */
+	return 2 * SUB_BUCKETS +
+		(msb - LATENCY_HIST_SUB_BITS - 1) * SUB_BUCKETS +
+		((val >> (msb - LATENCY_HIST_SUB_BITS)) & (SUB_BUCKETS - 1));
+}
+
+
+/* Highest value that is counted in the specified bucket */
+static u32 latency_hist_bucket_max(unsigned int idx)
+{
+	unsigned int shift, sub;
+
+	if (idx < 2 * SUB_BUCKETS)
+		return idx;
+
+	idx -= 2 * SUB_BUCKETS;
+	shift = idx / SUB_BUCKETS + 1;
+	sub = idx % SUB_BUCKETS;
+	return (((u32) (SUB_BUCKETS + sub + 1)) << shift) - 1;
+}
+
+
+void latency_hist_add(struct latency_hist *hist, u32 usec)
+{
+	hist->buckets[latency_hist_index(usec)]++;
+	hist->count++;
+	hist->sum += usec;
+	if (usec > hist->max)
+		hist->max = usec;
+}
+
+
+void latency_hist_add_since(struct latency_hist *hist,
+			    struct os_reltime *start)
+{
+	struct os_reltime age;
+	os_time_t usec;
+
+	os_reltime_age(start, &age);
+	if (age.sec < 0)
+		return;
+	if (age.sec >= 4000)
+		usec = 0xffffffff;
+	else
+		usec = age.sec * 1000000 + age.usec;
+	latency_hist_add(hist, usec);
+}
+
+
+/**
+ * latency_hist_percentile - Get a percentile from a histogram
+ * @hist: Histogram
+ * @percent: Percentile (0..100)
+ * Returns: Upper bound of the bucket that contains the percentile (limited
+ * to the largest recorded value) or 0 if the histogram is empty
+ */
+u32 latency_hist_percentile(const struct latency_hist *hist,
+			    unsigned int percent)
+{
+	u64 target, seen = 0;
+	unsigned int i;
+	u32 val;
+
+	if (!hist->count)
+		return 0;
+
+	target = ((u64) hist->count * percent + 99) / 100;
+	if (target == 0)
+		target = 1;
+	for (i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+		seen += hist->buckets[i];
+		if (seen >= target)
+			break;
+	}
+
+	val = latency_hist_bucket_max(i);
+	return val > hist->max ? hist->max : val;
+}
+
+
+/**
+ * latency_hist_print - Write a summary of a histogram into a text buffer
+ * @hist: Histogram
+ * @buf: Buffer for the text
+ * @buflen: Length of buf in octets
+ * Returns: Number of octets written into buf
+ */
+int latency_hist_print(const struct latency_hist *hist, char *buf,
+		       size_t buflen)
+{
+	int ret;
+
+	ret = os_snprintf(buf, buflen,
+			  "count=%u avg_us=%u p50_us=%u p90_us=%u p99_us=%u "
+			  "max_us=%u\n",
+			  hist->count,
+			  hist->count ? (u32) (hist->sum / hist->count) : 0,
+			  latency_hist_percentile(hist, 50),
+			  latency_hist_percentile(hist, 90),
+			  latency_hist_percentile(hist, 99),
+			  hist->max);
+	if (os_snprintf_error(buflen, ret))
+		return 0;
+	return ret;
+}
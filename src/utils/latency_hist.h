@@ -0,0 +1,41 @@
+/*
+ * Latency histograms
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+/*
+ * Values are recorded in microseconds into log-linear buckets: values below
+ * 16 have a bucket of their own and each power of two range above that is
+ * split into 8 buckets, i.e., the bucket width is at most 1/8 of the value.
+ */
+#define LATENCY_HIST_SUB_BITS 3
+#define LATENCY_HIST_BUCKETS (2 * (1 << LATENCY_HIST_SUB_BITS) + \
+			      (32 - LATENCY_HIST_SUB_BITS - 1) * \
+			      (1 << LATENCY_HIST_SUB_BITS))
+
+struct latency_hist {
+	u32 buckets[LATENCY_HIST_BUCKETS];
+	u32 count;
+	u32 max;
+	u64 sum;
+};
+
+void latency_hist_add(struct latency_hist *hist, u32 usec);
+void latency_hist_add_since(struct latency_hist *hist,
+			    struct os_reltime *start);
+u32 latency_hist_percentile(const struct latency_hist *hist,
+			    unsigned int percent);
+int latency_hist_print(const struct latency_hist *hist, char *buf,
+		       size_t buflen);
+
+static inline void latency_hist_reset(struct latency_hist *hist)
+{
+	os_memset(hist, 0, sizeof(*hist));
+}
+
+#endif /* LATENCY_HIST_H */
@@ -18,6 +18,7 @@
 #include "utils/ip_addr.h"
 #include "utils/eloop.h"
 #include "utils/json.h"
+#include "utils/latency_hist.h"
 #include "utils/module_tests.h"
 
 
@@ -1209,6 +1210,343 @@ static int const_time_tests(void)
 }
 
 
+static int debug_gate_evals;
+
+static const char * debug_gate_arg(void)
+{
+	debug_gate_evals++;
+	return "debug gating test";
+}
+
+
+static int latency_hist_tests(void)
+{
+	static const struct {
+		u32 val;
+		unsigned int idx;
+	} idx_tests[] = {
+		{ 0, 0 },
+		{ 15, 15 },
+		{ 16, 16 },
+		{ 17, 16 },
+		{ 18, 17 },
+		{ 31, 23 },
+		{ 32, 24 },
+		{ 35, 24 },
+		{ 36, 25 },
+		{ 0xffffffff, LATENCY_HIST_BUCKETS - 1 },
+	};
+	struct latency_hist hist;
+	char buf[100];
+	unsigned int i;
+	int errors = 0;
+
+	wpa_printf(MSG_INFO, "latency histogram tests");
+
+	for (i = 0; i < ARRAY_SIZE(idx_tests); i++) {
+		latency_hist_reset(&hist);
+		latency_hist_add(&hist, idx_tests[i].val);
+		if (hist.buckets[idx_tests[i].idx] != 1) {
+			wpa_printf(MSG_ERROR,
+				   "latency hist test %u: value %u not in bucket %u",
+				   i, idx_tests[i].val, idx_tests[i].idx);
+			errors++;
+		}
+	}
+
+	latency_hist_reset(&hist);
+	if (latency_hist_print(&hist, buf, sizeof(buf)) <= 0 ||
+	    os_strcmp(buf,
+		      "count=0 avg_us=0 p50_us=0 p90_us=0 p99_us=0 max_us=0\n")
+	    != 0) {
+		wpa_printf(MSG_ERROR, "latency hist empty print test failed");
+		errors++;
+	}
+
+	/*
+	 * 1..100: p50 is in bucket 48..51, p90 in 88..95, and p99 in 96..103
+	 * which is limited to the maximum recorded value.
+	 */
+	for (i = 1; i <= 100; i++)
+		latency_hist_add(&hist, i);
+	if (latency_hist_print(&hist, buf, sizeof(buf)) <= 0 ||
+	    os_strcmp(buf,
+		      "count=100 avg_us=50 p50_us=51 p90_us=95 p99_us=100 max_us=100\n")
+	    != 0) {
+		wpa_printf(MSG_ERROR, "latency hist print test failed: %s",
+			   buf);
+		errors++;
+	}
+
+	if (errors) {
+		wpa_printf(MSG_ERROR, "%d latency histogram test(s) failed",
+			   errors);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static int debug_gating_tests(void)
+{
+	int errors = 0;
+	int level = wpa_debug_level;
+#ifndef CONFIG_NO_HOSTAPD_LOGGER
+	unsigned int modules[HOSTAPD_LEVEL_WARNING + 1];
+#endif /* CONFIG_NO_HOSTAPD_LOGGER */
+
+	wpa_printf(MSG_INFO, "debug gating tests");
+
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+	if (wpa_debug_tracing)
+		return 0;
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+
+	wpa_debug_level = MSG_INFO;
+	debug_gate_evals = 0;
+	wpa_printf(MSG_DEBUG, "%s", debug_gate_arg());
+	wpa_printf(MSG_EXCESSIVE, "%s", debug_gate_arg());
+	wpa_hexdump(MSG_MSGDUMP, debug_gate_arg(), NULL, 0);
+	if (debug_gate_evals != 0) {
+		wpa_printf(MSG_ERROR,
+			   "debug gating test: arguments of a suppressed message evaluated");
+		errors++;
+	}
+	wpa_printf(MSG_INFO, "%s", debug_gate_arg());
+	if (debug_gate_evals != 1) {
+		wpa_printf(MSG_ERROR,
+			   "debug gating test: enabled message not printed");
+		errors++;
+	}
+	wpa_debug_level = level;
+
+#ifndef CONFIG_NO_HOSTAPD_LOGGER
+	os_memcpy(modules, hostapd_logger_modules, sizeof(modules));
+	hostapd_logger_modules[HOSTAPD_LEVEL_DEBUG] = HOSTAPD_MODULE_WPA;
+	debug_gate_evals = 0;
+	hostapd_logger(NULL, NULL, HOSTAPD_MODULE_RADIUS, HOSTAPD_LEVEL_DEBUG,
+		       "%s", debug_gate_arg());
+	if (debug_gate_evals != 0 ||
+	    !hostapd_logger_enabled(HOSTAPD_MODULE_WPA, HOSTAPD_LEVEL_DEBUG)) {
+		wpa_printf(MSG_ERROR,
+			   "debug gating test: hostapd_logger module level not applied");
+		errors++;
+	}
+	hostapd_logger_set_modules(modules);
+#endif /* CONFIG_NO_HOSTAPD_LOGGER */
+
+	if (errors) {
+		wpa_printf(MSG_ERROR, "%d debug gating test(s) failed", errors);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+#ifdef CONFIG_DEBUG_RING
+
+#define DEBUG_RING_TEST_FILE "/tmp/wpa_debug_ring_module_test"
+
+static void debug_ring_test_printf(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	wpa_debug_ring_vprintf(MSG_DEBUG, fmt, ap);
+	va_end(ap);
+}
+
+
+static const struct wpa_debug_ring_rec *
+debug_ring_test_rec(const u8 *file, u64 pos)
+{
+	const struct wpa_debug_ring_hdr *hdr =
+		(const struct wpa_debug_ring_hdr *) file;
+
+	return (const struct wpa_debug_ring_rec *)
+		(file + hdr->ring_off + pos % hdr->ring_len);
+}
+
+
+/* Check a printf record and return a pointer to its arguments */
+static const u8 * debug_ring_test_args(const u8 *file,
+				       const struct wpa_debug_ring_rec *rec,
+				       const char *fmt, size_t args_len)
+{
+	const struct wpa_debug_ring_hdr *hdr =
+		(const struct wpa_debug_ring_hdr *) file;
+
+	if (rec->type != WPA_DEBUG_RING_PRINTF || rec->flags ||
+	    rec->level != MSG_DEBUG ||
+	    rec->len != ((sizeof(*rec) + args_len + 3) & ~3) ||
+	    rec->fmt == WPA_DEBUG_RING_NO_FMT || rec->fmt >= hdr->fmt_used ||
+	    os_strcmp((const char *) file + hdr->fmt_off + rec->fmt, fmt) != 0)
+		return NULL;
+	return (const u8 *) (rec + 1);
+}
+
+
+static u64 debug_ring_test_u64(const u8 *pos)
+{
+	u64 val;
+
+	os_memcpy(&val, pos, sizeof(val));
+	return val;
+}
+
+
+static u16 debug_ring_test_u16(const u8 *pos)
+{
+	u16 val;
+
+	os_memcpy(&val, pos, sizeof(val));
+	return val;
+}
+
+
+static int debug_ring_record_tests(void)
+{
+	const struct wpa_debug_ring_hdr *hdr;
+	const struct wpa_debug_ring_rec *rec;
+	const char *null_str = NULL;
+	const u8 *args;
+	u8 *file;
+	size_t len;
+	u64 pos;
+	int ret = -1;
+
+	if (wpa_debug_open_ring(DEBUG_RING_TEST_FILE, 65536, MSG_ERROR + 1) < 0)
+		return -1;
+	debug_ring_test_printf("%d %lu %zu", -5, 123456789UL, (size_t) 42);
+	debug_ring_test_printf("%.*s|%s", 3, "abcdef", null_str);
+	debug_ring_test_printf("%p", (void *) 0x1234);
+	wpa_debug_close_ring();
+
+	file = (u8 *) os_readfile(DEBUG_RING_TEST_FILE, &len);
+	if (!file || len != 65536)
+		goto fail;
+	hdr = (const struct wpa_debug_ring_hdr *) file;
+	if (hdr->magic != WPA_DEBUG_RING_MAGIC ||
+	    hdr->version != WPA_DEBUG_RING_VERSION || hdr->tail != 0)
+		goto fail;
+
+	pos = hdr->tail;
+	rec = debug_ring_test_rec(file, pos);
+	args = debug_ring_test_args(file, rec, "%d %lu %zu", 3 * 8);
+	if (!args ||
+	    debug_ring_test_u64(args) != (u64) -5 ||
+	    debug_ring_test_u64(args + 8) != 123456789 ||
+	    debug_ring_test_u64(args + 16) != 42)
+		goto fail;
+
+	pos += rec->len;
+	rec = debug_ring_test_rec(file, pos);
+	args = debug_ring_test_args(file, rec, "%.*s|%s", 8 + 2 + 3 + 2);
+	if (!args ||
+	    debug_ring_test_u64(args) != 3 ||
+	    debug_ring_test_u16(args + 8) != 3 ||
+	    os_memcmp(args + 10, "abc", 3) != 0 ||
+	    debug_ring_test_u16(args + 13) != 0xffff)
+		goto fail;
+
+	pos += rec->len;
+	rec = debug_ring_test_rec(file, pos);
+	args = debug_ring_test_args(file, rec, "%p", 8);
+	if (!args || debug_ring_test_u64(args) != 0x1234)
+		goto fail;
+
+	pos += rec->len;
+	if (pos != hdr->head)
+		goto fail;
+
+	ret = 0;
+fail:
+	if (ret)
+		wpa_printf(MSG_ERROR, "debug ring record test failed");
+	os_free(file);
+	unlink(DEBUG_RING_TEST_FILE);
+	return ret;
+}
+
+
+static int debug_ring_wrap_tests(void)
+{
+	const struct wpa_debug_ring_hdr *hdr;
+	const struct wpa_debug_ring_rec *rec;
+	const u8 *args;
+	unsigned int i, count = 3000, first = 0, next = 0;
+	u8 *file;
+	size_t len;
+	u64 pos;
+	int ret = -1;
+
+	if (wpa_debug_open_ring(DEBUG_RING_TEST_FILE, 65536, MSG_ERROR + 1) < 0)
+		return -1;
+	for (i = 0; i < count; i++)
+		debug_ring_test_printf("seq %u", i);
+	wpa_debug_close_ring();
+
+	file = (u8 *) os_readfile(DEBUG_RING_TEST_FILE, &len);
+	if (!file || len != 65536)
+		goto fail;
+	hdr = (const struct wpa_debug_ring_hdr *) file;
+
+	/* The oldest records have been overwritten */
+	if (hdr->tail == 0 || hdr->head <= hdr->ring_len ||
+	    hdr->head - hdr->tail > hdr->ring_len)
+		goto fail;
+
+	/* The remaining records are complete and in order up to the newest */
+	for (pos = hdr->tail; pos < hdr->head; pos += rec->len) {
+		rec = debug_ring_test_rec(file, pos);
+		if (!rec->len)
+			goto fail;
+		if (rec->type == WPA_DEBUG_RING_PAD)
+			continue;
+		args = debug_ring_test_args(file, rec, "seq %u", 8);
+		if (!args)
+			goto fail;
+		if (pos == hdr->tail)
+			first = next = debug_ring_test_u64(args);
+		if (debug_ring_test_u64(args) != next)
+			goto fail;
+		next++;
+	}
+	if (pos != hdr->head || first == 0 || next != count)
+		goto fail;
+
+	ret = 0;
+fail:
+	if (ret)
+		wpa_printf(MSG_ERROR, "debug ring wrap test failed");
+	os_free(file);
+	unlink(DEBUG_RING_TEST_FILE);
+	return ret;
+}
+
+#endif /* CONFIG_DEBUG_RING */
+
+
+static int debug_ring_tests(void)
+{
+#ifdef CONFIG_DEBUG_RING
+	wpa_printf(MSG_INFO, "debug ring tests");
+
+	/* Do not replace a ring that was enabled with -R */
+	if (wpa_debug_ring_level <= MSG_ERROR)
+		return 0;
+
+	if (debug_ring_record_tests() < 0 ||
+	    debug_ring_wrap_tests() < 0)
+		return -1;
+#endif /* CONFIG_DEBUG_RING */
+
+	return 0;
+}
+
+
 int utils_module_tests(void)
 {
 	int ret = 0;
@@ -1227,7 +1565,10 @@ int utils_module_tests(void)
 	    eloop_tests() < 0 ||
 	    json_tests() < 0 ||
 	    const_time_tests() < 0 ||
-	    int_array_tests() < 0)
+	    int_array_tests() < 0 ||
+	    latency_hist_tests() < 0 ||
+	    debug_gating_tests() < 0 ||
+	    debug_ring_tests() < 0)
 		ret = -1;
 
 	return ret;
@@ -22,10 +22,16 @@
 #include <stdio.h>
 
 static FILE *wpa_debug_tracing_file = NULL;
+int wpa_debug_tracing = 0;
 
 #define WPAS_TRACE_PFX "wpas <%d>: "
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
 
+#ifdef CONFIG_DEBUG_RING
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif /* CONFIG_DEBUG_RING */
+
 
 int wpa_debug_level = MSG_INFO;
 int wpa_debug_show_keys = 0;
@@ -179,6 +185,7 @@ int wpa_debug_open_linux_tracing(void)
 		printf("failed to fdopen()\n");
 		return -1;
 	}
+	wpa_debug_tracing = 1;
 
 	return 0;
 }
@@ -190,11 +197,465 @@ void wpa_debug_close_linux_tracing(void)
 		return;
 	fclose(wpa_debug_tracing_file);
 	wpa_debug_tracing_file = NULL;
+	wpa_debug_tracing = 0;
 }
 
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
 
 
+#ifdef CONFIG_DEBUG_RING
+
+/*
+ * Binary debug trace ring
+ *
+ * Debug messages are stored unformatted in a memory mapped file so that
+ * MSG_DEBUG level traces can be left enabled in production without the cost
+ * of vfprintf() and a write per line. Each record holds the timestamp, an
+ * identifier of the format string and the raw argument values. The format
+ * strings themselves are stored once in a table in the same file. The file
+ * is rendered offline with wpa_supplicant/utils/debug_ring_decode.py, also
+ * after the process has crashed.
+ *
+ * File layout (host byte order):
+ *   struct wpa_debug_ring_hdr
+ *   format table: NUL terminated format strings; format id = offset
+ *   record ring: variable length records, 4 octet aligned, never wrapping;
+ *	the unused tail end of the ring is filled with a padding record
+ *
+ * Record arguments follow the conversions of the format string: 8 octets per
+ * integer, pointer, double, or '*' width/precision and, for %s, a 2 octet
+ * length (0xffff for a NULL pointer) followed by the (truncated) string.
+ * Hexdump records contain the title as a string, the 8 octet buffer length,
+ * the 8 octet number of stored octets, and the stored octets.
+ */
+
+#define WPA_DEBUG_RING_FMT_ENTRIES 1024
+#define WPA_DEBUG_RING_MAX_REC 2048
+#define WPA_DEBUG_RING_MAX_STR 256
+#define WPA_DEBUG_RING_MAX_HEXDUMP 1024
+
+int wpa_debug_ring_level = MSG_ERROR + 1;
+
+static struct wpa_debug_ring_hdr *ring_hdr;
+static size_t ring_map_len;
+static const char *fmt_ptr[WPA_DEBUG_RING_FMT_ENTRIES];
+static u32 fmt_id[WPA_DEBUG_RING_FMT_ENTRIES];
+
+
+static u32 ring_fmt_id(const char *fmt)
+{
+	char *table = (char *) ring_hdr + ring_hdr->fmt_off;
+	unsigned int idx, i;
+	size_t len;
+	u32 id;
+
+	idx = ((uintptr_t) fmt >> 2) % WPA_DEBUG_RING_FMT_ENTRIES;
+	for (i = 0; i < WPA_DEBUG_RING_FMT_ENTRIES; i++) {
+		if (!fmt_ptr[idx])
+			break;
+		/*
+		 * The string comparison catches format strings that are not
+		 * literals and change contents at the same address.
+		 */
+		if (fmt_ptr[idx] == fmt &&
+		    os_strcmp(table + fmt_id[idx], fmt) == 0)
+			return fmt_id[idx];
+		idx = (idx + 1) % WPA_DEBUG_RING_FMT_ENTRIES;
+	}
+	if (i == WPA_DEBUG_RING_FMT_ENTRIES)
+		return WPA_DEBUG_RING_NO_FMT;
+
+	len = os_strlen(fmt) + 1;
+	if (len > ring_hdr->fmt_len - ring_hdr->fmt_used)
+		return WPA_DEBUG_RING_NO_FMT;
+	id = ring_hdr->fmt_used;
+	os_memcpy(table + id, fmt, len);
+	ring_hdr->fmt_used += len;
+	fmt_ptr[idx] = fmt;
+	fmt_id[idx] = id;
+	return id;
+}
+
+
+static void ring_write(const u8 *rec, size_t len)
+{
+	u8 *ring = (u8 *) ring_hdr + ring_hdr->ring_off;
+	u32 size = ring_hdr->ring_len;
+	u32 pos = ring_hdr->head % size;
+	u32 pad = 0;
+
+	if (pos + len > size)
+		pad = size - pos;
+
+	/* Drop the oldest records that the new one (and padding) overwrites */
+	while (ring_hdr->head + pad + len - ring_hdr->tail > size) {
+		struct wpa_debug_ring_rec *old;
+
+		old = (struct wpa_debug_ring_rec *)
+			(ring + ring_hdr->tail % size);
+		if (!old->len) {
+			/* Should not happen; start over with an empty ring */
+			ring_hdr->tail = ring_hdr->head;
+			break;
+		}
+		ring_hdr->tail += old->len;
+	}
+
+	if (pad) {
+		struct wpa_debug_ring_rec *p;
+
+		p = (struct wpa_debug_ring_rec *) (ring + pos);
+		p->len = pad;
+		p->type = WPA_DEBUG_RING_PAD;
+		ring_hdr->head += pad;
+		pos = 0;
+	}
+
+	os_memcpy(ring + pos, rec, len);
+	ring_hdr->head += len;
+}
+
+
+static size_t ring_rec_init(u8 *buf, int type, int level, u32 fmt)
+{
+	struct wpa_debug_ring_rec *rec = (struct wpa_debug_ring_rec *) buf;
+	struct os_time tv;
+
+	os_get_time(&tv);
+	os_memset(rec, 0, sizeof(*rec));
+	rec->type = type;
+	rec->level = level;
+	rec->fmt = fmt;
+	rec->sec = tv.sec;
+	rec->usec = tv.usec;
+	return sizeof(*rec);
+}
+
+
+static void ring_rec_done(u8 *buf, size_t len)
+{
+	struct wpa_debug_ring_rec *rec = (struct wpa_debug_ring_rec *) buf;
+
+	len = (len + 3) & ~3;
+	rec->len = len;
+	ring_write(buf, len);
+}
+
+
+static int ring_put_u64(u8 *buf, size_t *pos, u64 val)
+{
+	if (*pos + sizeof(val) > WPA_DEBUG_RING_MAX_REC)
+		return -1;
+	os_memcpy(buf + *pos, &val, sizeof(val));
+	*pos += sizeof(val);
+	return 0;
+}
+
+
+static int ring_put_str(u8 *buf, size_t *pos, const char *str, int prec)
+{
+	u16 len = 0xffff;
+	size_t slen = 0;
+
+	if (str) {
+		while (slen < WPA_DEBUG_RING_MAX_STR &&
+		       (prec < 0 || slen < (size_t) prec) && str[slen])
+			slen++;
+		len = slen;
+	}
+	if (*pos + sizeof(len) + slen > WPA_DEBUG_RING_MAX_REC)
+		return -1;
+	os_memcpy(buf + *pos, &len, sizeof(len));
+	*pos += sizeof(len);
+	if (slen) {
+		os_memcpy(buf + *pos, str, slen);
+		*pos += slen;
+	}
+	return 0;
+}
+
+
+/* Copy the arguments of the conversions in fmt; returns 0 if all fit */
+static int ring_put_args(u8 *buf, size_t *pos, const char *fmt, va_list ap)
+{
+	const char *f = fmt;
+	int prec, lmod, ldbl, val;
+
+	while (*f) {
+		if (*f++ != '%')
+			continue;
+		if (*f == '%') {
+			f++;
+			continue;
+		}
+
+		while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' ||
+		       *f == '0' || *f == '\'')
+			f++;
+		if (*f == '*') {
+			f++;
+			val = va_arg(ap, int);
+			if (ring_put_u64(buf, pos, (s64) val))
+				return -1;
+		} else {
+			while (*f >= '0' && *f <= '9')
+				f++;
+		}
+		prec = -1;
+		if (*f == '.') {
+			f++;
+			if (*f == '*') {
+				f++;
+				prec = va_arg(ap, int);
+				if (ring_put_u64(buf, pos, (s64) prec))
+					return -1;
+			} else {
+				prec = 0;
+				while (*f >= '0' && *f <= '9')
+					prec = prec * 10 + *f++ - '0';
+			}
+		}
+
+		/* 'l' count: 0 = int, 1 = long, 2 = long long, 3 = size_t */
+		lmod = 0;
+		ldbl = 0;
+		for (;; f++) {
+			if (*f == 'l')
+				lmod++;
+			else if (*f == 'L')
+				ldbl = 1;
+			else if (*f == 'q' || *f == 'j')
+				lmod = 2;
+			else if (*f == 'z' || *f == 't')
+				lmod = 3;
+			else if (*f != 'h')
+				break;
+		}
+
+		switch (*f) {
+		case 'd':
+		case 'i':
+		{
+			s64 v;
+
+			if (lmod == 1)
+				v = va_arg(ap, long);
+			else if (lmod == 2)
+				v = va_arg(ap, long long);
+			else if (lmod == 3)
+				v = va_arg(ap, ssize_t);
+			else
+				v = va_arg(ap, int);
+			if (ring_put_u64(buf, pos, v))
+				return -1;
+			break;
+		}
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+		case 'c':
+		{
+			u64 v;
+
+			if (lmod == 1)
+				v = va_arg(ap, unsigned long);
+			else if (lmod == 2)
+				v = va_arg(ap, unsigned long long);
+			else if (lmod == 3)
+				v = va_arg(ap, size_t);
+			else
+				v = va_arg(ap, unsigned int);
+			if (ring_put_u64(buf, pos, v))
+				return -1;
+			break;
+		}
+		case 'p':
+			if (ring_put_u64(buf, pos,
+					 (uintptr_t) va_arg(ap, void *)))
+				return -1;
+			break;
+		case 's':
+			if (ring_put_str(buf, pos, va_arg(ap, const char *),
+					 prec))
+				return -1;
+			break;
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			double d;
+
+			if (ldbl)
+				d = va_arg(ap, long double);
+			else
+				d = va_arg(ap, double);
+			if (*pos + sizeof(d) > WPA_DEBUG_RING_MAX_REC)
+				return -1;
+			os_memcpy(buf + *pos, &d, sizeof(d));
+			*pos += sizeof(d);
+			break;
+		}
+		default:
+			/* Unsupported conversion; the rest cannot be parsed */
+			return -1;
+		}
+		f++;
+	}
+
+	return 0;
+}
+
+
+/**
+ * wpa_debug_ring_vprintf - Store a wpa_printf() message in the trace ring
+ * @level: priority level (MSG_*) of the message
+ * @fmt: printf format string
+ * @ap: Format arguments
+ */
+void wpa_debug_ring_vprintf(int level, const char *fmt, va_list ap)
+{
+	u32 rec[WPA_DEBUG_RING_MAX_REC / 4];
+	u8 *buf = (u8 *) rec;
+	struct wpa_debug_ring_rec *hdr = (struct wpa_debug_ring_rec *) rec;
+	size_t pos;
+	va_list ap2;
+
+	if (!ring_hdr)
+		return;
+
+	pos = ring_rec_init(buf, WPA_DEBUG_RING_PRINTF, level,
+			    ring_fmt_id(fmt));
+	if (hdr->fmt != WPA_DEBUG_RING_NO_FMT) {
+		va_copy(ap2, ap);
+		if (ring_put_args(buf, &pos, fmt, ap2))
+			hdr->flags |= WPA_DEBUG_RING_TRUNCATED;
+		va_end(ap2);
+	}
+	ring_rec_done(buf, pos);
+}
+
+
+/**
+ * wpa_debug_ring_hexdump - Store a hexdump in the trace ring
+ * @level: priority level (MSG_*) of the message
+ * @title: Title of the hexdump
+ * @buf: Data to dump or %NULL
+ * @len: Length of buf
+ * @show: Whether the data can be included (i.e., it is not a key)
+ * @ascii: Whether this is from wpa_hexdump_ascii*()
+ */
+void wpa_debug_ring_hexdump(int level, const char *title, const u8 *buf,
+			    size_t len, int show, int ascii)
+{
+	u32 rec[WPA_DEBUG_RING_MAX_REC / 4];
+	u8 *rbuf = (u8 *) rec;
+	struct wpa_debug_ring_rec *hdr = (struct wpa_debug_ring_rec *) rec;
+	size_t pos, dlen = 0;
+
+	if (!ring_hdr)
+		return;
+
+	pos = ring_rec_init(rbuf, WPA_DEBUG_RING_HEXDUMP, level,
+			    WPA_DEBUG_RING_NO_FMT);
+	if (ascii)
+		hdr->flags |= WPA_DEBUG_RING_ASCII;
+	if (!buf)
+		hdr->flags |= WPA_DEBUG_RING_NULL;
+	else if (!show)
+		hdr->flags |= WPA_DEBUG_RING_REMOVED;
+	else
+		dlen = len;
+	if (ring_put_str(rbuf, &pos, title, -1) ||
+	    pos + 2 * sizeof(u64) > WPA_DEBUG_RING_MAX_REC) {
+		hdr->flags |= WPA_DEBUG_RING_TRUNCATED;
+		ring_rec_done(rbuf, pos);
+		return;
+	}
+	if (dlen > WPA_DEBUG_RING_MAX_HEXDUMP)
+		dlen = WPA_DEBUG_RING_MAX_HEXDUMP;
+	if (dlen > WPA_DEBUG_RING_MAX_REC - pos - 2 * sizeof(u64))
+		dlen = WPA_DEBUG_RING_MAX_REC - pos - 2 * sizeof(u64);
+	if (buf && show && dlen < len)
+		hdr->flags |= WPA_DEBUG_RING_TRUNCATED;
+	/* Total length of the buffer and the number of octets stored */
+	ring_put_u64(rbuf, &pos, len);
+	ring_put_u64(rbuf, &pos, dlen);
+	if (dlen) {
+		os_memcpy(rbuf + pos, buf, dlen);
+		pos += dlen;
+	}
+	ring_rec_done(rbuf, pos);
+}
+
+
+/**
+ * wpa_debug_open_ring - Start recording debug messages to a trace ring file
+ * @path: Path of the ring file; an existing file is overwritten
+ * @size: Size of the file in octets
+ * @level: Minimum level (MSG_*) of the messages to record
+ * Returns: 0 on success, -1 on failure
+ */
+int wpa_debug_open_ring(const char *path, size_t size, int level)
+{
+	void *map;
+	int fd;
+
+	wpa_debug_close_ring();
+
+	if (size < 65536 || size > 0x7fffffff)
+		return -1;
+	size &= ~(size_t) 3;
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (fd < 0)
+		return -1;
+	if (ftruncate(fd, size) < 0) {
+		close(fd);
+		return -1;
+	}
+	map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -1;
+
+	ring_hdr = map;
+	ring_map_len = size;
+	os_memset(fmt_ptr, 0, sizeof(fmt_ptr));
+	ring_hdr->version = WPA_DEBUG_RING_VERSION;
+	ring_hdr->pid = getpid();
+	ring_hdr->fmt_off = sizeof(*ring_hdr);
+	ring_hdr->fmt_len = (size / 8) & ~3;
+	ring_hdr->fmt_used = 0;
+	ring_hdr->ring_off = ring_hdr->fmt_off + ring_hdr->fmt_len;
+	ring_hdr->ring_len = (size - ring_hdr->ring_off) & ~3;
+	ring_hdr->head = 0;
+	ring_hdr->tail = 0;
+	ring_hdr->magic = WPA_DEBUG_RING_MAGIC;
+
+	wpa_debug_ring_level = level;
+	return 0;
+}
+
+
+void wpa_debug_close_ring(void)
+{
+	wpa_debug_ring_level = MSG_ERROR + 1;
+	if (!ring_hdr)
+		return;
+	munmap(ring_hdr, ring_map_len);
+	ring_hdr = NULL;
+	ring_map_len = 0;
+}
+
+#endif /* CONFIG_DEBUG_RING */
+
+
 /**
  * wpa_printf - conditional printf
  * @level: priority level (MSG_*) of the message
@@ -206,10 +667,18 @@ void wpa_debug_close_linux_tracing(void)
  *
  * Note: New line '\n' is added to the end of the text when printing to stdout.
  */
-void wpa_printf(int level, const char *fmt, ...)
+void (wpa_printf)(int level, const char *fmt, ...)
 {
 	va_list ap;
 
+#ifdef CONFIG_DEBUG_RING
+	if (level >= wpa_debug_ring_level) {
+		va_start(ap, fmt);
+		wpa_debug_ring_vprintf(level, fmt, ap);
+		va_end(ap);
+	}
+#endif /* CONFIG_DEBUG_RING */
+
 	if (level >= wpa_debug_level) {
 #ifdef CONFIG_ANDROID_LOG
 		va_start(ap, fmt);
@@ -280,6 +749,10 @@ static void _wpa_hexdump(int level, const char *title, const u8 *buf,
 		fflush(wpa_debug_tracing_file);
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+	if (level >= wpa_debug_ring_level && !only_syslog)
+		wpa_debug_ring_hexdump(level, title, buf, len, show, 0);
+#endif /* CONFIG_DEBUG_RING */
 
 	if (level < wpa_debug_level)
 		return;
@@ -385,13 +858,14 @@ static void _wpa_hexdump(int level, const char *title, const u8 *buf,
 #endif /* CONFIG_ANDROID_LOG */
 }
 
-void wpa_hexdump(int level, const char *title, const void *buf, size_t len)
+void (wpa_hexdump)(int level, const char *title, const void *buf, size_t len)
 {
 	_wpa_hexdump(level, title, buf, len, 1, 0);
 }
 
 
-void wpa_hexdump_key(int level, const char *title, const void *buf, size_t len)
+void (wpa_hexdump_key)(int level, const char *title, const void *buf,
+		       size_t len)
 {
 	_wpa_hexdump(level, title, buf, len, wpa_debug_show_keys, 0);
 }
@@ -422,6 +896,11 @@ static void _wpa_hexdump_ascii(int level, const char *title, const void *buf,
 		fflush(wpa_debug_tracing_file);
 	}
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
+#if defined(CONFIG_DEBUG_RING) && !defined(CONFIG_ANDROID_LOG)
+	/* With Android logging, _wpa_hexdump() below records this */
+	if (level >= wpa_debug_ring_level)
+		wpa_debug_ring_hexdump(level, title, buf, len, show, 1);
+#endif /* CONFIG_DEBUG_RING && !CONFIG_ANDROID_LOG */
 
 	if (level < wpa_debug_level)
 		return;
@@ -510,15 +989,15 @@ file_done:
 }
 
 
-void wpa_hexdump_ascii(int level, const char *title, const void *buf,
-		       size_t len)
+void (wpa_hexdump_ascii)(int level, const char *title, const void *buf,
+			 size_t len)
 {
 	_wpa_hexdump_ascii(level, title, buf, len, 1);
 }
 
 
-void wpa_hexdump_ascii_key(int level, const char *title, const void *buf,
-			   size_t len)
+void (wpa_hexdump_ascii_key)(int level, const char *title, const void *buf,
+			     size_t len)
 {
 	_wpa_hexdump_ascii(level, title, buf, len, wpa_debug_show_keys);
 }
@@ -819,14 +1298,30 @@ void wpa_msg_global_only(void *ctx, int level, const char *fmt, ...)
 #ifndef CONFIG_NO_HOSTAPD_LOGGER
 static hostapd_logger_cb_func hostapd_logger_cb = NULL;
 
+unsigned int hostapd_logger_modules[HOSTAPD_LEVEL_WARNING + 1] = {
+	(unsigned int) -1, (unsigned int) -1, (unsigned int) -1,
+	(unsigned int) -1, (unsigned int) -1
+};
+
+
+void hostapd_logger_set_modules(const unsigned int *modules)
+{
+	int i;
+
+	for (i = 0; i <= HOSTAPD_LEVEL_WARNING; i++)
+		hostapd_logger_modules[i] = modules ? modules[i] :
+			(unsigned int) -1;
+}
+
+
 void hostapd_logger_register_cb(hostapd_logger_cb_func func)
 {
 	hostapd_logger_cb = func;
 }
 
 
-void hostapd_logger(void *ctx, const u8 *addr, unsigned int module, int level,
-		    const char *fmt, ...)
+void (hostapd_logger)(void *ctx, const u8 *addr, unsigned int module,
+		      int level, const char *fmt, ...)
 {
 	va_list ap;
 	char *buf;
@@ -15,6 +15,12 @@ extern int wpa_debug_level;
 extern int wpa_debug_show_keys;
 extern int wpa_debug_timestamp;
 extern int wpa_debug_syslog;
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+extern int wpa_debug_tracing;
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+extern int wpa_debug_ring_level;
+#endif /* CONFIG_DEBUG_RING */
 
 /* Debugging function - conditional printf and hex dump. Driver wrappers can
  * use these for debugging purposes. */
@@ -23,6 +29,15 @@ enum {
 	MSG_EXCESSIVE, MSG_MSGDUMP, MSG_DEBUG, MSG_INFO, MSG_WARNING, MSG_ERROR
 };
 
+/*
+ * Compile-time floor for debug output. Messages below this level are removed
+ * from the build together with the evaluation of their arguments. Set with
+ * CONFIG_DEBUG_MIN_LEVEL in the build configuration.
+ */
+#ifndef WPA_DEBUG_MIN_LEVEL
+#define WPA_DEBUG_MIN_LEVEL MSG_EXCESSIVE
+#endif /* WPA_DEBUG_MIN_LEVEL */
+
 #ifdef CONFIG_NO_STDOUT_DEBUG
 
 #define wpa_debug_print_timestamp() do { } while (0)
@@ -148,6 +163,44 @@ void wpa_hexdump_ascii(int level, const char *title, const void *buf,
 void wpa_hexdump_ascii_key(int level, const char *title, const void *buf,
 			   size_t len);
 
+/**
+ * wpa_debug_enabled - Whether a debug message at the given level is printed
+ * @level: priority level (MSG_*) of the message
+ *
+ * The macros below use this to skip the call, and with it the evaluation of
+ * the message arguments (MAC2STR(), helper functions building text, etc.),
+ * when the message would be dropped anyway.
+ */
+#ifdef CONFIG_DEBUG_LINUX_TRACING
+#define wpa_debug_tracing_enabled() wpa_debug_tracing
+#else /* CONFIG_DEBUG_LINUX_TRACING */
+#define wpa_debug_tracing_enabled() 0
+#endif /* CONFIG_DEBUG_LINUX_TRACING */
+#ifdef CONFIG_DEBUG_RING
+#define wpa_debug_ring_enabled(level) ((level) >= wpa_debug_ring_level)
+#else /* CONFIG_DEBUG_RING */
+#define wpa_debug_ring_enabled(level) 0
+#endif /* CONFIG_DEBUG_RING */
+#define wpa_debug_enabled(level) \
+	((level) >= WPA_DEBUG_MIN_LEVEL && \
+	 ((level) >= wpa_debug_level || wpa_debug_tracing_enabled() || \
+	  wpa_debug_ring_enabled(level)))
+
+#define wpa_printf(level, ...) \
+	(wpa_debug_enabled(level) ? wpa_printf((level), __VA_ARGS__) : (void) 0)
+#define wpa_hexdump(level, title, buf, len) \
+	(wpa_debug_enabled(level) ? \
+	 wpa_hexdump((level), (title), (buf), (len)) : (void) 0)
+#define wpa_hexdump_key(level, title, buf, len) \
+	(wpa_debug_enabled(level) ? \
+	 wpa_hexdump_key((level), (title), (buf), (len)) : (void) 0)
+#define wpa_hexdump_ascii(level, title, buf, len) \
+	(wpa_debug_enabled(level) ? \
+	 wpa_hexdump_ascii((level), (title), (buf), (len)) : (void) 0)
+#define wpa_hexdump_ascii_key(level, title, buf, len) \
+	(wpa_debug_enabled(level) ? \
+	 wpa_hexdump_ascii_key((level), (title), (buf), (len)) : (void) 0)
+
 /*
  * wpa_dbg() behaves like wpa_msg(), but it can be removed from build to reduce
  * binary size. As such, it should be used with debugging messages that are not
@@ -280,13 +333,58 @@ void wpa_msg_register_ifname_cb(wpa_msg_get_ifname_func func);
 
 #endif /* CONFIG_NO_WPA_MSG */
 
+#define HOSTAPD_MODULE_IEEE80211	0x00000001
+#define HOSTAPD_MODULE_IEEE8021X	0x00000002
+#define HOSTAPD_MODULE_RADIUS		0x00000004
+#define HOSTAPD_MODULE_WPA		0x00000008
+#define HOSTAPD_MODULE_DRIVER		0x00000010
+#define HOSTAPD_MODULE_MLME		0x00000040
+
+enum hostapd_logger_level {
+	HOSTAPD_LEVEL_DEBUG_VERBOSE = 0,
+	HOSTAPD_LEVEL_DEBUG = 1,
+	HOSTAPD_LEVEL_INFO = 2,
+	HOSTAPD_LEVEL_NOTICE = 3,
+	HOSTAPD_LEVEL_WARNING = 4
+};
+
 #ifdef CONFIG_NO_HOSTAPD_LOGGER
 #define hostapd_logger(args...) do { } while (0)
 #define hostapd_logger_register_cb(f) do { } while (0)
+#define hostapd_logger_set_modules(m) do { } while (0)
 #else /* CONFIG_NO_HOSTAPD_LOGGER */
 void hostapd_logger(void *ctx, const u8 *addr, unsigned int module, int level,
 		    const char *fmt, ...) PRINTF_FORMAT(5, 6);
 
+/*
+ * Bitmap of HOSTAPD_MODULE_* values per hostapd_logger_level for which some
+ * consumer of hostapd_logger() output is interested in messages. All modules
+ * are enabled on all levels unless the program narrows this down with
+ * hostapd_logger_set_modules().
+ */
+extern unsigned int hostapd_logger_modules[HOSTAPD_LEVEL_WARNING + 1];
+
+static inline int hostapd_logger_enabled(unsigned int module, int level)
+{
+	if (level < HOSTAPD_LEVEL_DEBUG_VERBOSE)
+		level = HOSTAPD_LEVEL_DEBUG_VERBOSE;
+	else if (level > HOSTAPD_LEVEL_WARNING)
+		level = HOSTAPD_LEVEL_WARNING;
+	return !!(hostapd_logger_modules[level] & module);
+}
+
+/**
+ * hostapd_logger_set_modules - Set the modules enabled on each logger level
+ * @modules: Array of HOSTAPD_LEVEL_WARNING + 1 module bitmaps or %NULL to
+ *	enable all modules on all levels
+ */
+void hostapd_logger_set_modules(const unsigned int *modules);
+
+#define hostapd_logger(ctx, addr, module, level, ...) \
+	(hostapd_logger_enabled((module), (level)) ? \
+	 hostapd_logger((ctx), (addr), (module), (level), __VA_ARGS__) : \
+	 (void) 0)
+
 typedef void (*hostapd_logger_cb_func)(void *ctx, const u8 *addr,
 				       unsigned int module, int level,
 				       const char *txt, size_t len);
@@ -298,21 +396,6 @@ typedef void (*hostapd_logger_cb_func)(void *ctx, const u8 *addr,
 void hostapd_logger_register_cb(hostapd_logger_cb_func func);
 #endif /* CONFIG_NO_HOSTAPD_LOGGER */
 
-#define HOSTAPD_MODULE_IEEE80211	0x00000001
-#define HOSTAPD_MODULE_IEEE8021X	0x00000002
-#define HOSTAPD_MODULE_RADIUS		0x00000004
-#define HOSTAPD_MODULE_WPA		0x00000008
-#define HOSTAPD_MODULE_DRIVER		0x00000010
-#define HOSTAPD_MODULE_MLME		0x00000040
-
-enum hostapd_logger_level {
-	HOSTAPD_LEVEL_DEBUG_VERBOSE = 0,
-	HOSTAPD_LEVEL_DEBUG = 1,
-	HOSTAPD_LEVEL_INFO = 2,
-	HOSTAPD_LEVEL_NOTICE = 3,
-	HOSTAPD_LEVEL_WARNING = 4
-};
-
 
 #ifdef CONFIG_DEBUG_SYSLOG
 
@@ -349,6 +432,72 @@ static inline void wpa_debug_close_linux_tracing(void)
 
 #endif /* CONFIG_DEBUG_LINUX_TRACING */
 
+/* Default size of the binary trace ring file (-R) */
+#define WPA_DEBUG_RING_DEFAULT_SIZE (4 * 1024 * 1024)
+
+#ifdef CONFIG_DEBUG_RING
+
+/* Trace ring file format; see wpa_debug.c for the layout */
+#define WPA_DEBUG_RING_MAGIC 0x47525744 /* "DWRG" */
+#define WPA_DEBUG_RING_VERSION 1
+#define WPA_DEBUG_RING_NO_FMT 0xffffffff /* wpa_debug_ring_rec::fmt */
+
+enum wpa_debug_ring_type {
+	WPA_DEBUG_RING_PAD = 0,
+	WPA_DEBUG_RING_PRINTF = 1,
+	WPA_DEBUG_RING_HEXDUMP = 2,
+};
+
+/* Record flags */
+#define WPA_DEBUG_RING_TRUNCATED BIT(0)
+#define WPA_DEBUG_RING_REMOVED BIT(1) /* hexdump of a key not shown */
+#define WPA_DEBUG_RING_NULL BIT(2) /* hexdump of a NULL buffer */
+#define WPA_DEBUG_RING_ASCII BIT(3) /* from wpa_hexdump_ascii*() */
+
+struct wpa_debug_ring_hdr {
+	u32 magic;
+	u32 version;
+	u32 pid;
+	u32 fmt_off;
+	u32 fmt_len;
+	u32 fmt_used;
+	u32 ring_off;
+	u32 ring_len;
+	u64 head; /* total number of octets written to the ring */
+	u64 tail; /* position of the oldest record still in the ring */
+};
+
+struct wpa_debug_ring_rec {
+	u16 len; /* including this header */
+	u8 type;
+	u8 level;
+	u8 flags;
+	u8 reserved[3];
+	u32 fmt;
+	u32 sec;
+	u32 usec;
+};
+
+int wpa_debug_open_ring(const char *path, size_t size, int level);
+void wpa_debug_close_ring(void);
+void wpa_debug_ring_vprintf(int level, const char *fmt, va_list ap);
+void wpa_debug_ring_hexdump(int level, const char *title, const u8 *buf,
+			    size_t len, int show, int ascii);
+
+#else /* CONFIG_DEBUG_RING */
+
+static inline int wpa_debug_open_ring(const char *path, size_t size,
+				      int level)
+{
+	return -1;
+}
+
+static inline void wpa_debug_close_ring(void)
+{
+}
+
+#endif /* CONFIG_DEBUG_RING */
+
 
 #ifdef EAPOL_TEST
 #define WPA_ASSERT(a)						       \
@@ -14,6 +14,7 @@ import time
 import binascii
 
 import hostapd
+import wpaspy
 import hwsim_utils
 from hwsim import HWSimRadio
 from wpasupplicant import WpaSupplicant
@@ -1935,6 +1936,79 @@ def test_wpas_ctrl_event_burst(dev, apdev):
     if not dev[0].ping():
         raise Exception("Could not ping wpa_supplicant at the end of the test")
 
+def pull_events(mon):
+    mon.s.send(b"EVENTS")
+    while True:
+        if not mon.pending(timeout=5):
+            raise Exception("No EVENTS response")
+        res = mon.recv()
+        # Skip notifications of new events that raced with the request
+        if not res.startswith("<"):
+            break
+    lines = res.splitlines()
+    vals = dict(v.split('=') for v in lines[0].split(' '))
+    return int(vals['pending']), int(vals['overruns']), lines[1:]
+
+def test_wpas_ctrl_event_pull(dev, apdev):
+    """wpa_supplicant control socket pull mode monitor"""
+    mon = wpaspy.Ctrl(os.path.join("/var/run/wpa_supplicant", dev[0].ifname))
+    try:
+        if "OK" not in mon.request("ATTACH pull=1"):
+            raise Exception("ATTACH pull=1 failed")
+        mon.attached = True
+
+        if "pull=1 pending=0 overruns=0" not in mon.request("MONITORS"):
+            raise Exception("Pull mode monitor not listed")
+
+        # A burst results in a single notification
+        if "OK" not in dev[0].request("EVENT_TEST 5"):
+            raise Exception("Could not request event messages")
+        if not mon.pending(timeout=5):
+            raise Exception("No pending events notification")
+        ev = mon.recv()
+        if "CTRL-EVENT-EVENTS-PENDING" not in ev:
+            raise Exception("Unexpected notification: " + ev)
+        time.sleep(0.2)
+        if mon.pending():
+            raise Exception("Unexpected extra datagram: " + mon.recv())
+
+        pending, overruns, events = pull_events(mon)
+        events = [e for e in events if "TEST-EVENT-MESSAGE" in e]
+        if pending != 0 or overruns != 0:
+            raise Exception("Unexpected EVENTS counters: %d %d" % (pending,
+                                                                   overruns))
+        if events != ["<3>TEST-EVENT-MESSAGE %d/5" % i for i in range(1, 6)]:
+            raise Exception("Unexpected events: " + str(events))
+
+        # More events than fit in the ring are accounted as overruns and
+        # the rest are read with more than one EVENTS command.
+        if "OK" not in dev[0].request("EVENT_TEST 300"):
+            raise Exception("Could not request event messages")
+        if not mon.pending(timeout=5):
+            raise Exception("No pending events notification")
+        mon.recv()
+        time.sleep(0.2)
+        total = []
+        lost = 0
+        for i in range(20):
+            pending, overruns, events = pull_events(mon)
+            lost = overruns
+            total += [e for e in events if "TEST-EVENT-MESSAGE" in e]
+            if pending == 0:
+                break
+        if pending != 0 or i == 0:
+            raise Exception("Events not read in multiple parts")
+        if lost < 300 - 256 or len(total) + lost < 300:
+            raise Exception("Unexpected event count: %d lost=%d" % (len(total),
+                                                                    lost))
+        if total[-1] != "<3>TEST-EVENT-MESSAGE 300/300":
+            raise Exception("Last event not received: " + total[-1])
+    finally:
+        mon.close()
+
+    if not dev[0].ping():
+        raise Exception("Could not ping wpa_supplicant at the end of the test")
+
 @remote_compatible
 def test_wpas_ctrl_sched_scan_plans(dev, apdev):
     """wpa_supplicant sched_scan_plans parsing"""
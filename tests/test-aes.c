@@ -11,43 +11,131 @@
 #include "common.h"
 #include "crypto/crypto.h"
 #include "crypto/aes_wrap.h"
+#include "crypto/aes_i.h"
 
 #define BLOCK_SIZE 16
 
+static double test_aes_perf_rate(struct os_reltime *start, size_t bytes)
+{
+	struct os_reltime now, diff;
+	double sec;
+
+	os_get_reltime(&now);
+	os_reltime_sub(&now, start, &diff);
+	sec = diff.sec + diff.usec / 1000000.0;
+	return sec > 0 ? bytes / sec / 1000000.0 : 0;
+}
+
+
 static void test_aes_perf(void)
 {
-#if 0 /* this did not seem to work with new compiler?! */
-#ifdef __i386__
-#define rdtscll(val) \
-     __asm__ __volatile__("rdtsc" : "=A" (val))
-	const int num_iters = 10;
-	int i;
-	unsigned int start, end;
-	u8 key[16], pt[16], ct[16];
+	const int num_iters = 100000;
+	const size_t frame_len = 1500;
+	u8 key[16], pt[16], ct[16], iv[12], tag[16];
+	u8 *frame, *crypt;
+	struct os_reltime start;
 	void *ctx;
+	int i;
 
-	printf("keySetupEnc:");
-	for (i = 0; i < num_iters; i++) {
-		rdtscll(start);
-		ctx = aes_encrypt_init(key, 16);
-		rdtscll(end);
-		aes_encrypt_deinit(ctx);
-		printf(" %d", end - start);
-	}
-	printf("\n");
-
-	printf("Encrypt:");
-	ctx = aes_encrypt_init(key, 16);
-	for (i = 0; i < num_iters; i++) {
-		rdtscll(start);
+	os_memset(key, 0x11, sizeof(key));
+	os_memset(pt, 0x22, sizeof(pt));
+	os_memset(iv, 0x33, sizeof(iv));
+	frame = os_zalloc(frame_len);
+	crypt = os_malloc(frame_len);
+	if (!frame || !crypt)
+		goto out;
+
+	ctx = aes_encrypt_init(key, sizeof(key));
+	if (!ctx)
+		goto out;
+	os_get_reltime(&start);
+	for (i = 0; i < num_iters * 10; i++)
 		aes_encrypt(ctx, pt, ct);
-		rdtscll(end);
-		printf(" %d", end - start);
-	}
+	printf("AES-128 block encrypt: %.1f MB/s\n",
+	       test_aes_perf_rate(&start, (size_t) num_iters * 10 * 16));
 	aes_encrypt_deinit(ctx);
-	printf("\n");
-#endif /* __i386__ */
-#endif
+
+	os_get_reltime(&start);
+	for (i = 0; i < num_iters / 10; i++)
+		if (aes_gcm_ae(key, sizeof(key), iv, sizeof(iv), frame,
+			       frame_len, NULL, 0, crypt, tag) < 0)
+			goto out;
+	printf("AES-128-GCM encrypt (%u octet frames): %.1f MB/s\n",
+	       (unsigned int) frame_len,
+	       test_aes_perf_rate(&start, (size_t) num_iters / 10 * frame_len));
+
+	os_get_reltime(&start);
+	for (i = 0; i < num_iters / 10; i++)
+		if (aes_gmac(key, sizeof(key), iv, sizeof(iv), frame,
+			     frame_len, tag) < 0)
+			goto out;
+	printf("AES-128-GMAC (%u octet frames): %.1f MB/s\n",
+	       (unsigned int) frame_len,
+	       test_aes_perf_rate(&start, (size_t) num_iters / 10 * frame_len));
+
+	os_get_reltime(&start);
+	for (i = 0; i < num_iters / 10; i++)
+		if (omac1_aes_128(key, frame, frame_len, tag) < 0)
+			goto out;
+	printf("AES-128-CMAC (%u octet frames): %.1f MB/s\n",
+	       (unsigned int) frame_len,
+	       test_aes_perf_rate(&start, (size_t) num_iters / 10 * frame_len));
+
+out:
+	os_free(frame);
+	os_free(crypt);
+}
+
+
+/*
+ * AES-CMAC test vectors from RFC 4493, Section 4
+ */
+static int test_cmac(void)
+{
+	static const u8 key[] = {
+		0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+		0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+	};
+	static const u8 msg[] = {
+		0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+		0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+		0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+		0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+		0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+		0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+		0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+		0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+	};
+	static const struct {
+		size_t len;
+		u8 mac[16];
+	} tests[] = {
+		{ 0, { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28,
+		       0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 } },
+		{ 16, { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44,
+			0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c } },
+		{ 40, { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30,
+			0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 } },
+		{ 64, { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92,
+			0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe } },
+	};
+	u8 mac[16];
+	unsigned int i;
+	int ret = 0;
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		if (omac1_aes_128(key, msg, tests[i].len, mac) < 0) {
+			printf("AES-CMAC failed (test case %u)\n", i);
+			ret++;
+			continue;
+		}
+		if (os_memcmp(mac, tests[i].mac, sizeof(mac)) != 0) {
+			printf("AES-CMAC mismatch (test case %u)\n", i);
+			ret++;
+		}
+	}
+
+	return ret;
 }
 
 
@@ -608,14 +696,23 @@ int main(int argc, char *argv[])
 {
 	int ret = 0;
 
+	if (argc >= 2 && os_strcmp(argv[1], "-p") == 0) {
+		/* Force the portable C implementation */
+		aes_accel_disabled = 1;
+		printf("AES/GHASH CPU acceleration disabled\n");
+		argc--;
+		argv++;
+	}
+
 	if (argc >= 3 && os_strcmp(argv[1], "NIST-KW-AE") == 0)
 		ret += test_nist_key_wrap_ae(argv[2]);
 	else if (argc >= 3 && os_strcmp(argv[1], "NIST-KW-AD") == 0)
 		ret += test_nist_key_wrap_ad(argv[2]);
-
-	test_aes_perf();
+	else if (argc >= 2 && os_strcmp(argv[1], "perf") == 0)
+		test_aes_perf();
 
 	ret += test_gcm();
+	ret += test_cmac();
 
 	if (ret)
 		printf("FAILED!\n");
@@ -0,0 +1,229 @@
+/*
+ * Element index - test program and microbenchmark
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#include "utils/includes.h"
+
+#include "utils/common.h"
+#include "utils/os.h"
+#include "common/ieee802_11_defs.h"
+#include "common/ieee802_11_common.h"
+
+
+/*
+ * Lookups done for a BSS entry during scan result processing, network
+ * selection, and association
+ */
+static const u8 query_eid[] = {
+	WLAN_EID_SSID, WLAN_EID_SUPP_RATES, WLAN_EID_EXT_SUPP_RATES,
+	WLAN_EID_DS_PARAMS, WLAN_EID_RSN, WLAN_EID_RSNX, WLAN_EID_HT_CAP,
+	WLAN_EID_HT_OPERATION, WLAN_EID_VHT_CAP, WLAN_EID_EXT_CAPAB,
+	WLAN_EID_MOBILITY_DOMAIN, WLAN_EID_INTERWORKING, WLAN_EID_MESH_ID,
+	WLAN_EID_ROAMING_CONSORTIUM, WLAN_EID_RRM_ENABLED_CAPABILITIES,
+};
+
+static const u8 query_ext[] = {
+	WLAN_EID_EXT_HE_CAPABILITIES, WLAN_EID_EXT_HE_OPERATION,
+	WLAN_EID_EXT_EDMG_OPERATION,
+};
+
+static const u32 query_vendor[] = {
+	WPA_IE_VENDOR_TYPE, WPS_IE_VENDOR_TYPE, P2P_IE_VENDOR_TYPE,
+	OSEN_IE_VENDOR_TYPE, MBO_IE_VENDOR_TYPE, HS20_IE_VENDOR_TYPE,
+};
+
+
+static int check_index(const struct ieee802_11_elem_index *idx,
+		       const u8 *ies, size_t len)
+{
+	unsigned int i;
+
+	for (i = 0; i < 256; i++) {
+		if (ieee802_11_elem_index_get(idx, ies, i) !=
+		    get_ie(ies, len, i) ||
+		    ieee802_11_elem_index_get_ext(idx, ies, i) !=
+		    get_ie_ext(ies, len, i))
+			return -1;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(query_vendor); i++) {
+		if (ieee802_11_elem_index_get_vendor(idx, ies,
+						     query_vendor[i]) !=
+		    get_vendor_ie(ies, len, query_vendor[i]))
+			return -1;
+	}
+
+	return 0;
+}
+
+
+static uintptr_t lookup_linear(const u8 *ies, size_t len)
+{
+	uintptr_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(query_eid); i++)
+		sum += (uintptr_t) get_ie(ies, len, query_eid[i]);
+	for (i = 0; i < ARRAY_SIZE(query_ext); i++)
+		sum += (uintptr_t) get_ie_ext(ies, len, query_ext[i]);
+	for (i = 0; i < ARRAY_SIZE(query_vendor); i++)
+		sum += (uintptr_t) get_vendor_ie(ies, len, query_vendor[i]);
+
+	return sum;
+}
+
+
+static uintptr_t lookup_index(const struct ieee802_11_elem_index *idx,
+			      const u8 *ies)
+{
+	uintptr_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(query_eid); i++)
+		sum += (uintptr_t) ieee802_11_elem_index_get(idx, ies,
+							     query_eid[i]);
+	for (i = 0; i < ARRAY_SIZE(query_ext); i++)
+		sum += (uintptr_t) ieee802_11_elem_index_get_ext(idx, ies,
+								 query_ext[i]);
+	for (i = 0; i < ARRAY_SIZE(query_vendor); i++)
+		sum += (uintptr_t) ieee802_11_elem_index_get_vendor(
+			idx, ies, query_vendor[i]);
+
+	return sum;
+}
+
+
+static unsigned int nsec_since(struct os_reltime *start,
+			       unsigned int rounds)
+{
+	struct os_reltime now, diff;
+
+	os_get_reltime(&now);
+	os_reltime_sub(&now, start, &diff);
+	return (diff.sec * 1000000 + diff.usec) * 1000 / rounds;
+}
+
+
+static int bench(const char *name, const u8 *ies, size_t len,
+		 unsigned int rounds)
+{
+	struct ieee802_11_elem_index *idx;
+	struct os_reltime start;
+	unsigned int i, t_build, t_linear, t_index;
+	uintptr_t sum_linear = 0, sum_index = 0;
+
+	idx = ieee802_11_elem_index_build(ies, len);
+	if (!idx || check_index(idx, ies, len) < 0) {
+		printf("%s: element index mismatch\n", name);
+		os_free(idx);
+		return -1;
+	}
+	os_free(idx);
+
+	os_get_reltime(&start);
+	for (i = 0; i < rounds; i++) {
+		idx = ieee802_11_elem_index_build(ies, len);
+		os_free(idx);
+	}
+	t_build = nsec_since(&start, rounds);
+
+	os_get_reltime(&start);
+	for (i = 0; i < rounds; i++)
+		sum_linear += lookup_linear(ies, len);
+	t_linear = nsec_since(&start, rounds);
+
+	idx = ieee802_11_elem_index_build(ies, len);
+	if (!idx)
+		return -1;
+	os_get_reltime(&start);
+	for (i = 0; i < rounds; i++)
+		sum_index += lookup_index(idx, ies);
+	t_index = nsec_since(&start, rounds);
+	os_free(idx);
+
+	if (sum_linear != sum_index) {
+		printf("%s: lookup mismatch\n", name);
+		return -1;
+	}
+
+	printf("%s: %u elements, %u octets: build %u ns, %u lookups: linear %u ns, index %u ns\n",
+	       name, ieee802_11_ie_count(ies, len), (unsigned int) len,
+	       t_build,
+	       (unsigned int) (ARRAY_SIZE(query_eid) + ARRAY_SIZE(query_ext) +
+			       ARRAY_SIZE(query_vendor)),
+	       t_linear, t_index);
+	return 0;
+}
+
+
+static void usage(void)
+{
+	printf("usage: test-ie-index [-m] [-r<rounds>] <file>...\n"
+	       "\n"
+	       "Each file contains the IEs of a Beacon or Probe Response frame\n"
+	       "(e.g., tests/fuzzing/p2p/corpus/proberesp.dat) or with -m,\n"
+	       "the full Beacon or Probe Response frame.\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	int c, i, ret = 0, frames = 0;
+	unsigned int rounds = 100000;
+	size_t hdr_len = IEEE80211_HDRLEN + sizeof(((struct ieee80211_mgmt *)
+						   NULL)->u.beacon);
+
+	for (;;) {
+		c = getopt(argc, argv, "mr:");
+		if (c < 0)
+			break;
+		switch (c) {
+		case 'm':
+			frames = 1;
+			break;
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		default:
+			usage();
+			return -1;
+		}
+	}
+
+	if (optind == argc || rounds == 0) {
+		usage();
+		return -1;
+	}
+
+	for (i = optind; i < argc; i++) {
+		char *data;
+		size_t len;
+		const u8 *ies;
+
+		data = os_readfile(argv[i], &len);
+		if (!data) {
+			printf("Could not read '%s'\n", argv[i]);
+			ret = -1;
+			continue;
+		}
+		ies = (const u8 *) data;
+		if (frames) {
+			if (len < hdr_len) {
+				printf("%s: too short frame\n", argv[i]);
+				os_free(data);
+				ret = -1;
+				continue;
+			}
+			ies += hdr_len;
+			len -= hdr_len;
+		}
+		if (bench(argv[i], ies, len, rounds) < 0)
+			ret = -1;
+		os_free(data);
+	}
+
+	return ret;
+}
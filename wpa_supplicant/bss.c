@@ -11,6 +11,8 @@
 #include "utils/common.h"
 #include "utils/eloop.h"
 #include "common/ieee802_11_defs.h"
+#include "common/ieee802_11_common.h"
+#include "common/wpa_common.h"
 #include "drivers/driver.h"
 #include "eap_peer/eap.h"
 #include "wpa_supplicant_i.h"
@@ -47,6 +49,35 @@ static void wpa_bss_set_hessid(struct wpa_bss *bss)
 }
 
 
+/*
+ * Index the elements and cache the security related IE information that BSS
+ * selection checks for each configured network so that they are parsed only
+ * when the IEs change.
+ */
+static void wpa_bss_parse_ies(struct wpa_bss *bss)
+{
+	const u8 *ie;
+	struct wpa_ie_data data;
+
+	os_free(bss->ie_index);
+	bss->ie_index = ieee802_11_elem_index_build((const u8 *) (bss + 1),
+						    bss->ie_len);
+
+	ie = wpa_bss_get_vendor_ie(bss, WPA_IE_VENDOR_TYPE);
+	bss->wpa_ie_len = ie ? ie[1] : 0;
+
+	ie = wpa_bss_get_ie(bss, WLAN_EID_RSN);
+	bss->rsn_ie_len = ie ? ie[1] : 0;
+	bss->rsn_osen = ie && wpa_parse_wpa_ie_rsn(ie, 2 + ie[1], &data) == 0 &&
+		(data.key_mgmt & WPA_KEY_MGMT_OSEN);
+
+	bss->osen = wpa_bss_get_vendor_ie(bss, OSEN_IE_VENDOR_TYPE) != NULL;
+
+	ie = wpa_bss_get_ie(bss, WLAN_EID_RSNX);
+	bss->rsnxe_capa = ie && ie[1] >= 1 ? ie[2] : 0;
+}
+
+
 /**
  * wpa_bss_anqp_alloc - Allocate ANQP data structure for a BSS entry
  * Returns: Allocated ANQP data structure or %NULL on failure
@@ -220,6 +251,37 @@ static void wpa_bss_update_pending_connect(struct wpa_supplicant *wpa_s,
 }
 
 
+static void wpa_bss_hash_add(struct wpa_supplicant *wpa_s, struct wpa_bss *bss)
+{
+	bss->hnext = wpa_s->bss_hash[WPA_BSS_HASH(bss->bssid)];
+	wpa_s->bss_hash[WPA_BSS_HASH(bss->bssid)] = bss;
+	bss->hnext_id = wpa_s->bss_id_hash[WPA_BSS_ID_HASH(bss->id)];
+	wpa_s->bss_id_hash[WPA_BSS_ID_HASH(bss->id)] = bss;
+}
+
+
+static void wpa_bss_hash_del(struct wpa_supplicant *wpa_s, struct wpa_bss *bss)
+{
+	struct wpa_bss **pos;
+
+	for (pos = &wpa_s->bss_hash[WPA_BSS_HASH(bss->bssid)]; *pos;
+	     pos = &(*pos)->hnext) {
+		if (*pos == bss) {
+			*pos = bss->hnext;
+			break;
+		}
+	}
+
+	for (pos = &wpa_s->bss_id_hash[WPA_BSS_ID_HASH(bss->id)]; *pos;
+	     pos = &(*pos)->hnext_id) {
+		if (*pos == bss) {
+			*pos = bss->hnext_id;
+			break;
+		}
+	}
+}
+
+
 void wpa_bss_remove(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 		    const char *reason)
 {
@@ -239,12 +301,14 @@ void wpa_bss_remove(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	wpa_bss_update_pending_connect(wpa_s, bss, NULL);
 	dl_list_del(&bss->list);
 	dl_list_del(&bss->list_id);
+	wpa_bss_hash_del(wpa_s, bss);
 	wpa_s->num_bss--;
 	wpa_dbg(wpa_s, MSG_DEBUG, "BSS: Remove id %u BSSID " MACSTR
 		" SSID '%s' due to %s", bss->id, MAC2STR(bss->bssid),
 		wpa_ssid_txt(bss->ssid, bss->ssid_len), reason);
 	wpas_notify_bss_removed(wpa_s, bss->bssid, bss->id);
 	wpa_bss_anqp_free(bss->anqp);
+	os_free(bss->ie_index);
 	os_free(bss);
 }
 
@@ -263,7 +327,8 @@ struct wpa_bss * wpa_bss_get(struct wpa_supplicant *wpa_s, const u8 *bssid,
 	struct wpa_bss *bss;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[WPA_BSS_HASH(bssid)]; bss;
+	     bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) == 0 &&
 		    bss->ssid_len == ssid_len &&
 		    os_memcmp(bss->ssid, ssid, ssid_len) == 0)
@@ -467,6 +532,7 @@ static struct wpa_bss * wpa_bss_add(struct wpa_supplicant *wpa_s,
 	bss->beacon_ie_len = res->beacon_ie_len;
 	os_memcpy(bss + 1, res + 1, res->ie_len + res->beacon_ie_len);
 	wpa_bss_set_hessid(bss);
+	wpa_bss_parse_ies(bss);
 
 	if (wpa_s->num_bss + 1 > wpa_s->conf->bss_max_count &&
 	    wpa_bss_remove_oldest(wpa_s) != 0) {
@@ -478,6 +544,7 @@ static struct wpa_bss * wpa_bss_add(struct wpa_supplicant *wpa_s,
 
 	dl_list_add_tail(&wpa_s->bss, &bss->list);
 	dl_list_add_tail(&wpa_s->bss_id, &bss->list_id);
+	wpa_bss_hash_add(wpa_s, bss);
 	wpa_s->num_bss++;
 	if (!is_zero_ether_addr(bss->hessid))
 		os_snprintf(extra, sizeof(extra), " HESSID " MACSTR,
@@ -672,8 +739,10 @@ wpa_bss_update(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	bss->scan_miss_count = 0;
 	bss->last_update_idx = wpa_s->bss_update_idx;
 	wpa_bss_copy_res(bss, res, fetch_time);
-	/* Move the entry to the end of the list */
+	/* Move the entry to the end of the list and the front of its hash
+	 * chain */
 	dl_list_del(&bss->list);
+	wpa_bss_hash_del(wpa_s, bss);
 #ifdef CONFIG_P2P
 	if (wpa_bss_get_vendor_ie(bss, P2P_IE_VENDOR_TYPE) &&
 	    !wpa_scan_get_vendor_ie(res, P2P_IE_VENDOR_TYPE)) {
@@ -690,8 +759,15 @@ wpa_bss_update(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 			MAC2STR(bss->bssid));
 	} else
 #endif /* CONFIG_P2P */
-	if (bss->ie_len + bss->beacon_ie_len >=
-	    res->ie_len + res->beacon_ie_len) {
+	if (!(changes & WPA_BSS_IES_CHANGED_FLAG) &&
+	    bss->beacon_ie_len == res->beacon_ie_len &&
+	    os_memcmp((const u8 *) (bss + 1) + bss->ie_len,
+		      (const u8 *) (res + 1) + res->ie_len,
+		      res->beacon_ie_len) == 0) {
+		/* Unchanged IEs (the common case for a BSS that is seen in
+		 * consecutive scans) do not need to be copied again. */
+	} else if (bss->ie_len + bss->beacon_ie_len >=
+		   res->ie_len + res->beacon_ie_len) {
 		os_memcpy(bss + 1, res + 1, res->ie_len + res->beacon_ie_len);
 		bss->ie_len = res->ie_len;
 		bss->beacon_ie_len = res->beacon_ie_len;
@@ -720,9 +796,12 @@ wpa_bss_update(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 		}
 		dl_list_add(prev, &bss->list_id);
 	}
-	if (changes & WPA_BSS_IES_CHANGED_FLAG)
+	if (changes & WPA_BSS_IES_CHANGED_FLAG) {
 		wpa_bss_set_hessid(bss);
+		wpa_bss_parse_ies(bss);
+	}
 	dl_list_add_tail(&wpa_s->bss, &bss->list);
+	wpa_bss_hash_add(wpa_s, bss);
 
 	notify_bss_changes(wpa_s, changes, bss);
 
@@ -1022,7 +1101,8 @@ struct wpa_bss * wpa_bss_get_bssid(struct wpa_supplicant *wpa_s,
 	struct wpa_bss *bss;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each_reverse(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[WPA_BSS_HASH(bssid)]; bss;
+	     bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) == 0)
 			return bss;
 	}
@@ -1047,7 +1127,8 @@ struct wpa_bss * wpa_bss_get_bssid_latest(struct wpa_supplicant *wpa_s,
 	struct wpa_bss *bss, *found = NULL;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each_reverse(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[WPA_BSS_HASH(bssid)]; bss;
+	     bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) != 0)
 			continue;
 		if (found == NULL ||
@@ -1097,7 +1178,8 @@ struct wpa_bss * wpa_bss_get_p2p_dev_addr(struct wpa_supplicant *wpa_s,
 struct wpa_bss * wpa_bss_get_id(struct wpa_supplicant *wpa_s, unsigned int id)
 {
 	struct wpa_bss *bss;
-	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_id_hash[WPA_BSS_ID_HASH(id)]; bss;
+	     bss = bss->hnext_id) {
 		if (bss->id == id)
 			return bss;
 	}
@@ -1139,10 +1221,32 @@ struct wpa_bss * wpa_bss_get_id_range(struct wpa_supplicant *wpa_s,
  */
 const u8 * wpa_bss_get_ie(const struct wpa_bss *bss, u8 ie)
 {
+	if (bss->ie_index)
+		return ieee802_11_elem_index_get(bss->ie_index,
+						 (const u8 *) (bss + 1), ie);
 	return get_ie((const u8 *) (bss + 1), bss->ie_len, ie);
 }
 
 
+/**
+ * wpa_bss_get_ie_ext - Fetch a specified extended IE from a BSS entry
+ * @bss: BSS table entry
+ * @ext: Information element extension identifier (WLAN_EID_EXT_*)
+ * Returns: Pointer to the information element (id field) or %NULL if not found
+ *
+ * This function returns the first matching information element in the BSS
+ * entry.
+ */
+const u8 * wpa_bss_get_ie_ext(const struct wpa_bss *bss, u8 ext)
+{
+	if (bss->ie_index)
+		return ieee802_11_elem_index_get_ext(bss->ie_index,
+						     (const u8 *) (bss + 1),
+						     ext);
+	return get_ie_ext((const u8 *) (bss + 1), bss->ie_len, ext);
+}
+
+
 /**
  * wpa_bss_get_vendor_ie - Fetch a vendor information element from a BSS entry
  * @bss: BSS table entry
@@ -1159,6 +1263,10 @@ const u8 * wpa_bss_get_vendor_ie(const struct wpa_bss *bss, u32 vendor_type)
 	pos = (const u8 *) (bss + 1);
 	end = pos + bss->ie_len;
 
+	if (bss->ie_index)
+		return ieee802_11_elem_index_get_vendor(bss->ie_index, pos,
+							vendor_type);
+
 	while (end - pos > 1) {
 		if (2 + pos[1] > end - pos)
 			break;
@@ -67,6 +67,10 @@ struct wpa_bss {
 	struct dl_list list;
 	/** List entry for struct wpa_supplicant::bss_id */
 	struct dl_list list_id;
+	/** Next entry in struct wpa_supplicant::bss_hash chain */
+	struct wpa_bss *hnext;
+	/** Next entry in struct wpa_supplicant::bss_id_hash chain */
+	struct wpa_bss *hnext_id;
 	/** Unique identifier for this BSS entry */
 	unsigned int id;
 	/** Number of counts without seeing this BSS */
@@ -105,6 +109,18 @@ struct wpa_bss {
 	int snr;
 	/** ANQP data */
 	struct wpa_bss_anqp *anqp;
+	/** Length of the WPA IE payload (0 if no WPA IE) */
+	u8 wpa_ie_len;
+	/** Length of the RSN IE payload (0 if no RSN IE) */
+	u8 rsn_ie_len;
+	/** RSNXE capabilities (first octet of the RSNXE, 0 if none) */
+	u8 rsnxe_capa;
+	/** Whether the BSS advertises OSEN in an OSEN IE */
+	bool osen;
+	/** Whether the BSS advertises OSEN AKM in the RSN IE */
+	bool rsn_osen;
+	/** Element index of the Probe Response IEs or %NULL if not available */
+	struct ieee802_11_elem_index *ie_index;
 	/** Length of the following IE field in octets (from Probe Response) */
 	size_t ie_len;
 	/** Length of the following Beacon IE field in octets */
@@ -137,6 +153,7 @@ struct wpa_bss * wpa_bss_get_id(struct wpa_supplicant *wpa_s, unsigned int id);
 struct wpa_bss * wpa_bss_get_id_range(struct wpa_supplicant *wpa_s,
 				      unsigned int idf, unsigned int idl);
 const u8 * wpa_bss_get_ie(const struct wpa_bss *bss, u8 ie);
+const u8 * wpa_bss_get_ie_ext(const struct wpa_bss *bss, u8 ext);
 const u8 * wpa_bss_get_vendor_ie(const struct wpa_bss *bss, u32 vendor_type);
 const u8 * wpa_bss_get_vendor_ie_beacon(const struct wpa_bss *bss,
 					u32 vendor_type);
@@ -19,6 +19,9 @@
 #include "common/ieee802_11_defs.h"
 #include "common/ieee802_11_common.h"
 #include "common/wpa_ctrl.h"
+#ifdef CONFIG_CTRL_IFACE_UNIX
+#include "common/ctrl_iface_common.h"
+#endif /* CONFIG_CTRL_IFACE_UNIX */
 #ifdef CONFIG_DPP
 #include "common/dpp.h"
 #endif /* CONFIG_DPP */
@@ -3030,8 +3033,7 @@ static int wpa_supplicant_ctrl_iface_scan_result(
 	if (bss_is_dmg(bss)) {
 		const char *s;
 
-		if (get_ie_ext((const u8 *) (bss + 1), bss->ie_len,
-			       WLAN_EID_EXT_EDMG_OPERATION)) {
+		if (wpa_bss_get_ie_ext(bss, WLAN_EID_EXT_EDMG_OPERATION)) {
 			ret = os_snprintf(pos, end - pos, "[EDMG]");
 			if (os_snprintf_error(end - pos, ret))
 				return -1;
@@ -10457,6 +10459,13 @@ char * wpa_supplicant_ctrl_iface_process(struct wpa_supplicant *wpa_s,
 			reply_len = -1;
 	} else if (os_strncmp(buf, "NOTE ", 5) == 0) {
 		wpa_printf(MSG_INFO, "NOTE: %s", buf + 5);
+#ifdef CONFIG_CTRL_IFACE_UNIX
+	} else if (os_strcmp(buf, "CTRL_STATS") == 0) {
+		reply_len = ctrl_iface_cmd_stats_print(wpa_s->global->ctrl_stats,
+						       reply, reply_size);
+	} else if (os_strcmp(buf, "CTRL_STATS reset") == 0) {
+		ctrl_iface_cmd_stats_flush(wpa_s->global->ctrl_stats);
+#endif /* CONFIG_CTRL_IFACE_UNIX */
 	} else if (os_strcmp(buf, "MIB") == 0) {
 		reply_len = wpa_sm_get_mib(wpa_s->wpa, reply, reply_size);
 		if (reply_len >= 0) {
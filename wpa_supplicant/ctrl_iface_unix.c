@@ -31,6 +31,9 @@
 
 /* Per-interface ctrl_iface */
 
+#define CTRL_IFACE_EVENTS_LEN 4096
+#define CTRL_IFACE_MONITORS_LEN 4096
+
 struct ctrl_iface_priv {
 	struct wpa_supplicant *wpa_s;
 	int sock;
@@ -38,6 +41,7 @@ struct ctrl_iface_priv {
 	int android_control_socket;
 	struct dl_list msg_queue;
 	unsigned int throttle_count;
+	struct ctrl_iface_event_ring events; /* for pull mode monitors */
 };
 
 
@@ -48,6 +52,7 @@ struct ctrl_iface_global_priv {
 	int android_control_socket;
 	struct dl_list msg_queue;
 	unsigned int throttle_count;
+	struct ctrl_iface_event_ring events; /* for pull mode monitors */
 };
 
 struct ctrl_iface_msg {
@@ -115,6 +120,68 @@ static int wpa_supplicant_ctrl_iface_detach(struct dl_list *ctrl_dst,
 }
 
 
+static int wpas_ctrl_iface_attach_params(struct dl_list *ctrl_dst,
+					 struct ctrl_iface_event_ring *ring,
+					 struct sockaddr_storage *from,
+					 socklen_t fromlen, const char *params)
+{
+	struct wpa_ctrl_dst *dst;
+
+	if (ctrl_iface_attach(ctrl_dst, from, fromlen, params))
+		return -1;
+
+	dst = ctrl_iface_get_dst(ctrl_dst, from, fromlen);
+	if (dst && dst->pull) {
+		/* Only events after the attachment are delivered */
+		dst->cursor = ring->head;
+		dst->notified = 0;
+	}
+	return 0;
+}
+
+
+static char * wpas_ctrl_iface_events(struct dl_list *ctrl_dst,
+				     struct ctrl_iface_event_ring *ring,
+				     struct sockaddr_storage *from,
+				     socklen_t fromlen, size_t *reply_len)
+{
+	struct wpa_ctrl_dst *dst;
+	char *reply;
+	int res;
+
+	dst = ctrl_iface_get_dst(ctrl_dst, from, fromlen);
+	if (!dst || !dst->pull)
+		return NULL;
+
+	reply = os_malloc(CTRL_IFACE_EVENTS_LEN);
+	if (!reply)
+		return NULL;
+	res = ctrl_iface_event_ring_pull(ring, dst, reply,
+					 CTRL_IFACE_EVENTS_LEN);
+	if (res < 0) {
+		os_free(reply);
+		return NULL;
+	}
+	*reply_len = res;
+	return reply;
+}
+
+
+static char * wpas_ctrl_iface_monitors(struct dl_list *ctrl_dst,
+				       struct ctrl_iface_event_ring *ring,
+				       size_t *reply_len)
+{
+	char *reply;
+
+	reply = os_malloc(CTRL_IFACE_MONITORS_LEN);
+	if (!reply)
+		return NULL;
+	*reply_len = ctrl_iface_monitors(ctrl_dst, ring, reply,
+					 CTRL_IFACE_MONITORS_LEN);
+	return reply;
+}
+
+
 static int wpa_supplicant_ctrl_iface_level(struct ctrl_iface_priv *priv,
 					   struct sockaddr_storage *from,
 					   socklen_t fromlen,
@@ -171,15 +238,44 @@ static void wpa_supplicant_ctrl_iface_receive(int sock, void *eloop_ctx,
 			reply_len = 1;
 		else
 			reply_len = 2;
+	} else if (os_strncmp(buf, "ATTACH ", 7) == 0) {
+		if (wpas_ctrl_iface_attach_params(&priv->ctrl_dst,
+						  &priv->events, &from,
+						  fromlen, buf + 7))
+			reply_len = 1;
+		else {
+			new_attached = 1;
+			reply_len = 2;
+		}
 	} else if (os_strncmp(buf, "LEVEL ", 6) == 0) {
 		if (wpa_supplicant_ctrl_iface_level(priv, &from, fromlen,
 						    buf + 6))
 			reply_len = 1;
 		else
 			reply_len = 2;
+	} else if (os_strcmp(buf, "EVENTS") == 0) {
+		reply_buf = wpas_ctrl_iface_events(&priv->ctrl_dst,
+						   &priv->events, &from,
+						   fromlen, &reply_len);
+		reply = reply_buf;
+		if (!reply)
+			reply_len = 1;
+	} else if (os_strcmp(buf, "MONITORS") == 0) {
+		reply_buf = wpas_ctrl_iface_monitors(&priv->ctrl_dst,
+						     &priv->events, &reply_len);
+		reply = reply_buf;
+		if (!reply)
+			reply_len = 1;
 	} else {
+		char name[CTRL_IFACE_CMD_NAME_LEN];
+		struct os_reltime start;
+
+		ctrl_iface_cmd_name(buf, name, sizeof(name));
+		os_get_reltime(&start);
 		reply_buf = wpa_supplicant_ctrl_iface_process(wpa_s, buf,
 							      &reply_len);
+		ctrl_iface_cmd_stats_add(wpa_s->global->ctrl_stats, name,
+					 &start);
 		reply = reply_buf;
 
 		/*
@@ -857,6 +953,7 @@ void wpa_supplicant_ctrl_iface_deinit(struct ctrl_iface_priv *priv)
 	}
 
 free_dst:
+	ctrl_iface_event_ring_flush(&priv->events);
 	dl_list_for_each_safe(dst, prev, &priv->ctrl_dst, struct wpa_ctrl_dst,
 			      list) {
 		dl_list_del(&dst->list);
@@ -902,14 +999,20 @@ static void wpa_supplicant_ctrl_iface_send(struct wpa_supplicant *wpa_s,
 					   struct ctrl_iface_global_priv *gp)
 {
 	struct wpa_ctrl_dst *dst, *next;
-	char levelstr[10];
-	int idx, res;
-	struct msghdr msg;
-	struct iovec io[5];
+	struct ctrl_iface_event_ring *ring = NULL;
+	char levelstr[10], pending[50];
+	int idx, res, stored = 0;
+	struct msghdr msg, nmsg;
+	struct iovec io[5], nio;
 
 	if (sock < 0 || dl_list_empty(ctrl_dst))
 		return;
 
+	if (priv)
+		ring = &priv->events;
+	else if (gp)
+		ring = &gp->events;
+
 	res = os_snprintf(levelstr, sizeof(levelstr), "<%d>", level);
 	if (os_snprintf_error(sizeof(levelstr), res))
 		return;
@@ -935,6 +1038,16 @@ static void wpa_supplicant_ctrl_iface_send(struct wpa_supplicant *wpa_s,
 	msg.msg_iov = io;
 	msg.msg_iovlen = idx;
 
+	res = os_snprintf(pending, sizeof(pending), "%s%s", levelstr,
+			  WPA_EVENT_EVENTS_PENDING);
+	if (os_snprintf_error(sizeof(pending), res))
+		return;
+	nio.iov_base = pending;
+	nio.iov_len = res;
+	os_memset(&nmsg, 0, sizeof(nmsg));
+	nmsg.msg_iov = &nio;
+	nmsg.msg_iovlen = 1;
+
 	dl_list_for_each_safe(dst, next, ctrl_dst, struct wpa_ctrl_dst, list) {
 		int _errno;
 		char txt[200];
@@ -942,15 +1055,38 @@ static void wpa_supplicant_ctrl_iface_send(struct wpa_supplicant *wpa_s,
 		if (level < dst->debug_level)
 			continue;
 
-		msg.msg_name = (void *) &dst->addr;
-		msg.msg_namelen = dst->addrlen;
-		wpas_ctrl_sock_debug("ctrl_sock-sendmsg", sock, buf, len);
-		if (sendmsg(sock, &msg, MSG_DONTWAIT) >= 0) {
-			sockaddr_print(MSG_MSGDUMP,
-				       "CTRL_IFACE monitor sent successfully to",
-				       &dst->addr, dst->addrlen);
-			dst->errors = 0;
-			continue;
+		if (dst->pull && ring) {
+			/*
+			 * Store the event once for all pull mode monitors and
+			 * only notify the ones that have not yet been told
+			 * about pending events.
+			 */
+			if (!stored) {
+				ctrl_iface_event_ring_add(ring, level, io, idx);
+				stored = 1;
+			}
+			if (dst->notified)
+				continue;
+			nmsg.msg_name = (void *) &dst->addr;
+			nmsg.msg_namelen = dst->addrlen;
+			if (sendmsg(sock, &nmsg, MSG_DONTWAIT) >= 0) {
+				dst->notified = 1;
+				dst->errors = 0;
+				continue;
+			}
+		} else {
+			msg.msg_name = (void *) &dst->addr;
+			msg.msg_namelen = dst->addrlen;
+			wpas_ctrl_sock_debug("ctrl_sock-sendmsg", sock, buf,
+					     len);
+			if (sendmsg(sock, &msg, MSG_DONTWAIT) >= 0) {
+				sockaddr_print(MSG_MSGDUMP,
+					       "CTRL_IFACE monitor sent successfully to",
+					       &dst->addr, dst->addrlen);
+				dst->errors = 0;
+				dst->sent++;
+				continue;
+			}
 		}
 
 		_errno = errno;
@@ -1087,15 +1223,41 @@ static void wpa_supplicant_global_ctrl_iface_receive(int sock, void *eloop_ctx,
 			reply_len = 1;
 		else
 			reply_len = 2;
+	} else if (os_strncmp(buf, "ATTACH ", 7) == 0) {
+		if (wpas_ctrl_iface_attach_params(&priv->ctrl_dst,
+						  &priv->events, &from,
+						  fromlen, buf + 7))
+			reply_len = 1;
+		else
+			reply_len = 2;
 	} else if (os_strcmp(buf, "DETACH") == 0) {
 		if (wpa_supplicant_ctrl_iface_detach(&priv->ctrl_dst, &from,
 						     fromlen))
 			reply_len = 1;
 		else
 			reply_len = 2;
+	} else if (os_strcmp(buf, "EVENTS") == 0) {
+		reply_buf = wpas_ctrl_iface_events(&priv->ctrl_dst,
+						   &priv->events, &from,
+						   fromlen, &reply_len);
+		reply = reply_buf;
+		if (!reply)
+			reply_len = 1;
+	} else if (os_strcmp(buf, "MONITORS") == 0) {
+		reply_buf = wpas_ctrl_iface_monitors(&priv->ctrl_dst,
+						     &priv->events, &reply_len);
+		reply = reply_buf;
+		if (!reply)
+			reply_len = 1;
 	} else {
+		char name[CTRL_IFACE_CMD_NAME_LEN];
+		struct os_reltime start;
+
+		ctrl_iface_cmd_name(buf, name, sizeof(name));
+		os_get_reltime(&start);
 		reply_buf = wpa_supplicant_global_ctrl_iface_process(
 			global, buf, &reply_len);
+		ctrl_iface_cmd_stats_add(global->ctrl_stats, name, &start);
 		reply = reply_buf;
 
 		/*
@@ -1321,11 +1483,14 @@ wpa_supplicant_global_ctrl_iface_init(struct wpa_global *global)
 	dl_list_init(&priv->msg_queue);
 	priv->global = global;
 	priv->sock = -1;
+	global->ctrl_stats = ctrl_iface_cmd_stats_init();
 
 	if (global->params.ctrl_interface == NULL)
 		return priv;
 
 	if (wpas_global_ctrl_iface_open_sock(global, priv) < 0) {
+		ctrl_iface_cmd_stats_deinit(global->ctrl_stats);
+		global->ctrl_stats = NULL;
 		os_free(priv);
 		return NULL;
 	}
@@ -1376,6 +1541,7 @@ wpa_supplicant_global_ctrl_iface_deinit(struct ctrl_iface_global_priv *priv)
 	}
 	if (priv->global->params.ctrl_interface)
 		unlink(priv->global->params.ctrl_interface);
+	ctrl_iface_event_ring_flush(&priv->events);
 	dl_list_for_each_safe(dst, prev, &priv->ctrl_dst, struct wpa_ctrl_dst,
 			      list) {
 		dl_list_del(&dst->list);
@@ -1386,5 +1552,7 @@ wpa_supplicant_global_ctrl_iface_deinit(struct ctrl_iface_global_priv *priv)
 		dl_list_del(&msg->list);
 		os_free(msg);
 	}
+	ctrl_iface_cmd_stats_deinit(priv->global->ctrl_stats);
+	priv->global->ctrl_stats = NULL;
 	os_free(priv);
 }
@@ -1100,15 +1100,10 @@ static bool sae_pk_acceptable_bss_with_pk(struct wpa_supplicant *wpa_s,
 
 	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
 		int count;
-		const u8 *ie;
-		u8 rsnxe_capa = 0;
 
 		if (bss == orig_bss)
 			continue;
-		ie = wpa_bss_get_ie(bss, WLAN_EID_RSNX);
-		if (ie && ie[1] >= 1)
-			rsnxe_capa = ie[2];
-		if (!(rsnxe_capa & BIT(WLAN_RSNX_CAPAB_SAE_PK)))
+		if (!(bss->rsnxe_capa & BIT(WLAN_RSNX_CAPAB_SAE_PK)))
 			continue;
 
 		/* TODO: Could be more thorough in checking what kind of
@@ -1134,31 +1129,17 @@ static bool wpa_scan_res_ok(struct wpa_supplicant *wpa_s, struct wpa_ssid *ssid,
 			    bool debug_print)
 {
 	int res;
-	bool wpa, check_ssid, osen, rsn_osen = false;
-	struct wpa_ie_data data;
+	bool wpa, check_ssid, osen, rsn_osen;
 #ifdef CONFIG_MBO
 	const u8 *assoc_disallow;
 #endif /* CONFIG_MBO */
 #ifdef CONFIG_SAE
-	u8 rsnxe_capa = 0;
+	u8 rsnxe_capa = bss->rsnxe_capa;
 #endif /* CONFIG_SAE */
-	const u8 *ie;
-
-	ie = wpa_bss_get_vendor_ie(bss, WPA_IE_VENDOR_TYPE);
-	wpa = ie && ie[1];
-	ie = wpa_bss_get_ie(bss, WLAN_EID_RSN);
-	wpa |= ie && ie[1];
-	if (ie && wpa_parse_wpa_ie_rsn(ie, 2 + ie[1], &data) == 0 &&
-	    (data.key_mgmt & WPA_KEY_MGMT_OSEN))
-		rsn_osen = true;
-	ie = wpa_bss_get_vendor_ie(bss, OSEN_IE_VENDOR_TYPE);
-	osen = ie != NULL;
 
-#ifdef CONFIG_SAE
-	ie = wpa_bss_get_ie(bss, WLAN_EID_RSNX);
-	if (ie && ie[1] >= 1)
-		rsnxe_capa = ie[2];
-#endif /* CONFIG_SAE */
+	wpa = bss->wpa_ie_len || bss->rsn_ie_len;
+	rsn_osen = bss->rsn_osen;
+	osen = bss->osen;
 
 	check_ssid = wpa || ssid->ssid_len > 0;
 
@@ -1354,6 +1335,7 @@ static bool wpa_scan_res_ok(struct wpa_supplicant *wpa_s, struct wpa_ssid *ssid,
 
 	if (!is_zero_ether_addr(ssid->go_p2p_dev_addr)) {
 		struct wpabuf *p2p_ie;
+		const u8 *ie;
 		u8 dev_addr[ETH_ALEN];
 
 		ie = wpa_bss_get_vendor_ie(bss, P2P_IE_VENDOR_TYPE);
@@ -1466,41 +1448,112 @@ skip_assoc_disallow:
 }
 
 
+static size_t wpas_ssid_index_hash(const u8 *ssid, size_t ssid_len)
+{
+	u32 hash = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < ssid_len; i++) {
+		hash ^= ssid[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+
+static void wpas_ssid_index_build(struct wpa_supplicant *wpa_s)
+{
+	struct wpa_ssid *ssid;
+	size_t count = 0, size = 8, pos;
+
+	for (ssid = wpa_s->conf->ssid; ssid; ssid = ssid->next)
+		count++;
+	while (size < 2 * count)
+		size <<= 1;
+
+	wpa_s->ssid_index = os_calloc(size, sizeof(struct wpa_ssid *));
+	if (!wpa_s->ssid_index)
+		return; /* match against all networks in each priority group */
+	wpa_s->ssid_index_size = size;
+
+	for (ssid = wpa_s->conf->ssid; ssid; ssid = ssid->next) {
+		pos = wpas_ssid_index_hash(ssid->ssid, ssid->ssid_len);
+		while (wpa_s->ssid_index[pos & (size - 1)])
+			pos++;
+		wpa_s->ssid_index[pos & (size - 1)] = ssid;
+	}
+}
+
+
+static void wpas_ssid_index_free(struct wpa_supplicant *wpa_s)
+{
+	os_free(wpa_s->ssid_index);
+	wpa_s->ssid_index = NULL;
+	wpa_s->ssid_index_size = 0;
+}
+
+
+static bool wpas_ssid_index_match(struct wpa_supplicant *wpa_s,
+				  const u8 *match_ssid, size_t match_ssid_len,
+				  int priority)
+{
+	size_t mask = wpa_s->ssid_index_size - 1, pos;
+	struct wpa_ssid *ssid;
+
+	pos = wpas_ssid_index_hash(match_ssid, match_ssid_len);
+	while ((ssid = wpa_s->ssid_index[pos & mask])) {
+		if (ssid->priority == priority &&
+		    ssid->ssid_len == match_ssid_len &&
+		    (match_ssid_len == 0 ||
+		     os_memcmp(ssid->ssid, match_ssid, match_ssid_len) == 0))
+			return true;
+		pos++;
+	}
+
+	return false;
+}
+
+
+/*
+ * Networks without an SSID may match any BSS (wildcard, WPS, or BSSID only),
+ * but all other networks require an exact SSID match in wpa_scan_res_ok(), so
+ * a BSS can be skipped for a priority group that has neither.
+ */
+static bool wpas_ssid_index_group_match(struct wpa_supplicant *wpa_s,
+					struct wpa_ssid *group,
+					const u8 *match_ssid,
+					size_t match_ssid_len)
+{
+	return wpas_ssid_index_match(wpa_s, match_ssid, match_ssid_len,
+				     group->priority) ||
+		wpas_ssid_index_match(wpa_s, match_ssid, 0, group->priority);
+}
+
+
 struct wpa_ssid * wpa_scan_res_match(struct wpa_supplicant *wpa_s,
 				     int i, struct wpa_bss *bss,
 				     struct wpa_ssid *group,
 				     int only_first_ssid, int debug_print)
 {
-	u8 wpa_ie_len, rsn_ie_len;
-	const u8 *ie;
 	struct wpa_ssid *ssid;
-	int osen;
 	const u8 *match_ssid;
 	size_t match_ssid_len;
 	int blacklist_count;
 
-	ie = wpa_bss_get_vendor_ie(bss, WPA_IE_VENDOR_TYPE);
-	wpa_ie_len = ie ? ie[1] : 0;
-
-	ie = wpa_bss_get_ie(bss, WLAN_EID_RSN);
-	rsn_ie_len = ie ? ie[1] : 0;
-
-	ie = wpa_bss_get_vendor_ie(bss, OSEN_IE_VENDOR_TYPE);
-	osen = ie != NULL;
-
 	if (debug_print) {
 		wpa_dbg(wpa_s, MSG_DEBUG, "%d: " MACSTR
 			" ssid='%s' wpa_ie_len=%u rsn_ie_len=%u caps=0x%x level=%d freq=%d %s%s%s",
 			i, MAC2STR(bss->bssid),
 			wpa_ssid_txt(bss->ssid, bss->ssid_len),
-			wpa_ie_len, rsn_ie_len, bss->caps, bss->level,
+			bss->wpa_ie_len, bss->rsn_ie_len, bss->caps, bss->level,
 			bss->freq,
 			wpa_bss_get_vendor_ie(bss, WPS_IE_VENDOR_TYPE) ?
 			" wps" : "",
 			(wpa_bss_get_vendor_ie(bss, P2P_IE_VENDOR_TYPE) ||
 			 wpa_bss_get_vendor_ie_beacon(bss, P2P_IE_VENDOR_TYPE))
 			? " p2p" : "",
-			osen ? " osen=1" : "");
+			bss->osen ? " osen=1" : "");
 	}
 
 	blacklist_count = wpa_blacklist_is_blacklisted(wpa_s, bss->bssid);
@@ -1555,6 +1608,15 @@ struct wpa_ssid * wpa_scan_res_match(struct wpa_supplicant *wpa_s,
 		return NULL;
 	}
 
+	if (!only_first_ssid && wpa_s->ssid_index &&
+	    !wpas_ssid_index_group_match(wpa_s, group, match_ssid,
+					 match_ssid_len)) {
+		if (debug_print)
+			wpa_dbg(wpa_s, MSG_DEBUG,
+				"   skip - no network with matching SSID in priority group");
+		return NULL;
+	}
+
 	for (ssid = group; ssid; ssid = only_first_ssid ? NULL : ssid->pnext) {
 		if (wpa_scan_res_ok(wpa_s, ssid, match_ssid, match_ssid_len,
 				    bss, blacklist_count, debug_print))
@@ -1643,6 +1705,7 @@ struct wpa_bss * wpa_supplicant_pick_network(struct wpa_supplicant *wpa_s,
 		wpa_s->next_ssid = NULL;
 	}
 
+	wpas_ssid_index_build(wpa_s);
 	while (selected == NULL) {
 		for (prio = 0; prio < wpa_s->conf->num_prio; prio++) {
 			if (next_ssid && next_ssid->priority ==
@@ -1668,6 +1731,7 @@ struct wpa_bss * wpa_supplicant_pick_network(struct wpa_supplicant *wpa_s,
 		} else if (selected == NULL)
 			break;
 	}
+	wpas_ssid_index_free(wpa_s);
 
 	ssid = *selected_ssid;
 	if (selected && ssid && ssid->mem_only_psk && !ssid->psk_set &&
@@ -40,6 +40,9 @@ static void usage(void)
 #ifdef CONFIG_DEBUG_FILE
 	       " [-f<debug file>]"
 #endif /* CONFIG_DEBUG_FILE */
+#ifdef CONFIG_DEBUG_RING
+	       " [-R<trace ring file>]"
+#endif /* CONFIG_DEBUG_RING */
 	       " \\\n"
 	       "        [-o<override driver>] [-O<override ctrl>] \\\n"
 	       "        [-N -i<ifname> -c<conf> [-C<ctrl>] "
@@ -90,6 +93,9 @@ static void usage(void)
 	       "  -p = driver parameters\n"
 	       "  -P = PID file\n"
 	       "  -q = decrease debugging verbosity (-qq even less)\n"
+#ifdef CONFIG_DEBUG_RING
+	       "  -R = record debug messages to a binary trace ring file\n"
+#endif /* CONFIG_DEBUG_RING */
 #ifdef CONFIG_DEBUG_SYSLOG
 	       "  -s = log output to syslog instead of stdout\n"
 #endif /* CONFIG_DEBUG_SYSLOG */
@@ -201,7 +207,7 @@ int main(int argc, char *argv[])
 
 	for (;;) {
 		c = getopt(argc, argv,
-			   "b:Bc:C:D:de:f:g:G:hi:I:KLMm:No:O:p:P:qsTtuvW");
+			   "b:Bc:C:D:de:f:g:G:hi:I:KLMm:No:O:p:P:qR:sTtuvW");
 		if (c < 0)
 			break;
 		switch (c) {
@@ -282,6 +288,11 @@ int main(int argc, char *argv[])
 		case 'q':
 			params.wpa_debug_level++;
 			break;
+#ifdef CONFIG_DEBUG_RING
+		case 'R':
+			params.wpa_debug_ring_path = optarg;
+			break;
+#endif /* CONFIG_DEBUG_RING */
 #ifdef CONFIG_DEBUG_SYSLOG
 		case 's':
 			params.wpa_debug_syslog++;
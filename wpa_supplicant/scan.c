@@ -1978,10 +1978,8 @@ static int wpa_scan_result_compar(const void *a, const void *b)
 	int snr_a, snr_b, snr_a_full, snr_b_full;
 
 	/* WPA/WPA2 support preferred */
-	wpa_a = wpa_scan_get_vendor_ie(wa, WPA_IE_VENDOR_TYPE) != NULL ||
-		wpa_scan_get_ie(wa, WLAN_EID_RSN) != NULL;
-	wpa_b = wpa_scan_get_vendor_ie(wb, WPA_IE_VENDOR_TYPE) != NULL ||
-		wpa_scan_get_ie(wb, WLAN_EID_RSN) != NULL;
+	wpa_a = wa->wpa;
+	wpa_b = wb->wpa;
 
 	if (wpa_b && !wpa_a)
 		return 1;
@@ -2449,6 +2447,10 @@ wpa_supplicant_get_scan_results(struct wpa_supplicant *wpa_s,
 
 		scan_snr(scan_res_item);
 		scan_est_throughput(wpa_s, scan_res_item);
+		scan_res_item->wpa =
+			wpa_scan_get_vendor_ie(scan_res_item,
+					       WPA_IE_VENDOR_TYPE) ||
+			wpa_scan_get_ie(scan_res_item, WLAN_EID_RSN);
 	}
 
 #ifdef CONFIG_WPS
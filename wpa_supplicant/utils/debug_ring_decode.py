@@ -0,0 +1,180 @@
+#!/usr/bin/env python
+#
+# Decoder for binary debug trace ring files (CONFIG_DEBUG_RING, -R)
+#
+# This software may be distributed under the terms of the BSD license.
+# See README for more details.
+
+import sys, struct, re
+
+MAGIC = 0x47525744
+HDR = 'IIIIIIIIQQ'
+REC = 'HBBB3xIII'
+NO_FMT = 0xffffffff
+
+TYPE_PAD = 0
+TYPE_PRINTF = 1
+TYPE_HEXDUMP = 2
+
+FLAG_TRUNCATED = 0x01
+FLAG_REMOVED = 0x02
+FLAG_NULL = 0x04
+FLAG_ASCII = 0x08
+
+LEVELS = ['EXCESSIVE', 'MSGDUMP', 'DEBUG', 'INFO', 'WARNING', 'ERROR']
+
+# Same conversion syntax as ring_put_args() in src/utils/wpa_debug.c
+CONV = re.compile(r"%([-+ #0']*)(\*|\d+)?(?:\.(\*|\d*))?([hlLqjzt]*)([a-zA-Z%])")
+
+class Args:
+    def __init__(self, data, pos, end, order):
+        self.data = data
+        self.pos = pos
+        self.end = end
+        self.order = order
+
+    def num(self, signed):
+        if self.pos + 8 > self.end:
+            raise IndexError
+        val = struct.unpack_from(self.order + ('q' if signed else 'Q'),
+                                 self.data, self.pos)[0]
+        self.pos += 8
+        return val
+
+    def double(self):
+        if self.pos + 8 > self.end:
+            raise IndexError
+        val = struct.unpack_from(self.order + 'd', self.data, self.pos)[0]
+        self.pos += 8
+        return val
+
+    def string(self):
+        if self.pos + 2 > self.end:
+            raise IndexError
+        slen = struct.unpack_from(self.order + 'H', self.data, self.pos)[0]
+        self.pos += 2
+        if slen == 0xffff:
+            return None
+        if self.pos + slen > self.end:
+            raise IndexError
+        val = self.data[self.pos:self.pos + slen]
+        self.pos += slen
+        return val.decode('utf-8', 'replace')
+
+def render(fmt, args):
+    out = []
+    last = 0
+    for m in CONV.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, lmod, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        flags = flags.replace("'", '')
+        if width == '*':
+            width = str(args.num(True))
+        if prec == '*':
+            prec = str(args.num(True))
+        spec = '%' + flags + (width or '')
+        if prec is not None:
+            spec += '.' + (prec or '0')
+        if conv in 'di':
+            out.append((spec + 'd') % args.num(True))
+        elif conv in 'uoxXc':
+            out.append((spec + conv) % args.num(False))
+        elif conv == 'p':
+            out.append((spec + '#x') % args.num(False))
+        elif conv == 's':
+            val = args.string()
+            out.append((spec + 's') % ('(null)' if val is None else val))
+        elif conv in 'eEfFgGaA':
+            if conv in 'aA':
+                out.append(float.hex(args.double()))
+            else:
+                out.append((spec + conv) % args.double())
+        else:
+            raise IndexError
+    out.append(fmt[last:])
+    return ''.join(out)
+
+def decode_record(rtype, flags, fmt, fmt_table, args, data):
+    if rtype == TYPE_PRINTF:
+        if fmt == NO_FMT:
+            return '(format table full)'
+        end = fmt_table.index(b'\0', fmt)
+        fmt_str = fmt_table[fmt:end].decode('utf-8', 'replace')
+        try:
+            return render(fmt_str, args)
+        except (IndexError, TypeError, ValueError):
+            return fmt_str + ' [undecodable]'
+    if rtype == TYPE_HEXDUMP:
+        title = args.string()
+        dlen = args.num(False)
+        stored = args.num(False)
+        txt = '%s - hexdump%s(len=%d):' % \
+            (title, '_ascii' if flags & FLAG_ASCII else '', dlen)
+        if flags & FLAG_NULL:
+            txt += ' [NULL]'
+        elif flags & FLAG_REMOVED:
+            txt += ' [REMOVED]'
+        else:
+            txt += ''.join([' %02x' % c for c in
+                            bytearray(data[args.pos:args.pos + stored])])
+        return txt
+    return '(unknown record type %d)' % rtype
+
+def decode(data, min_level):
+    order = '<'
+    if struct.unpack_from('<I', data, 0)[0] != MAGIC:
+        order = '>'
+        if struct.unpack_from('>I', data, 0)[0] != MAGIC:
+            raise Exception('Not a debug trace ring file')
+    (magic, version, pid, fmt_off, fmt_len, fmt_used, ring_off, ring_len,
+     head, tail) = struct.unpack_from(order + HDR, data, 0)
+    if version != 1:
+        raise Exception('Unsupported version %d' % version)
+    sys.stderr.write('pid %d: %d octets of records, %d octets of formats\n' %
+                     (pid, head - tail, fmt_used))
+    fmt_table = data[fmt_off:fmt_off + fmt_used]
+    rec_len = struct.calcsize(order + REC)
+
+    pos = tail
+    while pos < head:
+        off = ring_off + pos % ring_len
+        rlen, rtype = struct.unpack_from(order + 'HB', data, off)
+        if rlen == 0:
+            break
+        pos += rlen
+        if rtype == TYPE_PAD:
+            continue
+        (rlen, rtype, level, flags, fmt, sec,
+         usec) = struct.unpack_from(order + REC, data, off)
+        if level < min_level:
+            continue
+        args = Args(data, off + rec_len, off + rlen, order)
+        try:
+            txt = decode_record(rtype, flags, fmt, fmt_table, args, data)
+        except (IndexError, TypeError, ValueError):
+            txt = '(undecodable record)'
+        if flags & FLAG_TRUNCATED:
+            txt += ' [truncated]'
+        print('%d.%06u: %s' % (sec, usec, txt))
+
+def usage():
+    print('usage: debug_ring_decode.py <ring file> [min level]')
+    print('')
+    print('levels: ' + ' '.join(LEVELS))
+    sys.exit(1)
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        usage()
+    min_level = 0
+    if len(sys.argv) > 2:
+        if sys.argv[2].upper() not in LEVELS:
+            usage()
+        min_level = LEVELS.index(sys.argv[2].upper())
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+    decode(data, min_level)
@@ -339,6 +339,19 @@ static int wpa_cli_cmd_mib(struct wpa_ctrl *ctrl, int argc, char *argv[])
 }
 
 
+static int wpa_cli_cmd_ctrl_stats(struct wpa_ctrl *ctrl, int argc,
+				  char *argv[])
+{
+	return wpa_cli_cmd(ctrl, "CTRL_STATS", 0, argc, argv);
+}
+
+
+static int wpa_cli_cmd_monitors(struct wpa_ctrl *ctrl, int argc, char *argv[])
+{
+	return wpa_ctrl_command(ctrl, "MONITORS");
+}
+
+
 static int wpa_cli_cmd_pmksa(struct wpa_ctrl *ctrl, int argc, char *argv[])
 {
 	return wpa_ctrl_command(ctrl, "PMKSA");
@@ -3204,6 +3217,12 @@ static const struct wpa_cli_cmd wpa_cli_commands[] = {
 	{ "mib", wpa_cli_cmd_mib, NULL,
 	  cli_cmd_flag_none,
 	  "= get MIB variables (dot1x, dot11)" },
+	{ "ctrl_stats", wpa_cli_cmd_ctrl_stats, NULL,
+	  cli_cmd_flag_none,
+	  "[reset] = show (or reset) control interface command statistics" },
+	{ "monitors", wpa_cli_cmd_monitors, NULL,
+	  cli_cmd_flag_none,
+	  "= show event delivery counters of attached monitors" },
 	{ "help", wpa_cli_cmd_help, wpa_cli_complete_help,
 	  cli_cmd_flag_none,
 	  "[command] = show usage help" },
@@ -3640,8 +3640,8 @@ static void wpas_start_assoc_cb(struct wpa_radio_work *work, int deinit)
 	}
 
 	if (bss && ssid->enable_edmg)
-		edmg_ie_oper = get_ie_ext((const u8 *) (bss + 1), bss->ie_len,
-					  WLAN_EID_EXT_EDMG_OPERATION);
+		edmg_ie_oper = wpa_bss_get_ie_ext(bss,
+						  WLAN_EID_EXT_EDMG_OPERATION);
 	else
 		edmg_ie_oper = NULL;
 
@@ -7071,6 +7071,15 @@ struct wpa_global * wpa_supplicant_init(struct wpa_params *params)
 			return NULL;
 		}
 	}
+	if (params->wpa_debug_ring_path &&
+	    wpa_debug_open_ring(params->wpa_debug_ring_path,
+				WPA_DEBUG_RING_DEFAULT_SIZE,
+				params->wpa_debug_level < MSG_DEBUG ?
+				params->wpa_debug_level : MSG_DEBUG)) {
+		wpa_printf(MSG_ERROR, "Failed to open trace ring file %s",
+			   params->wpa_debug_ring_path);
+		return NULL;
+	}
 
 	ret = eap_register_methods();
 	if (ret) {
@@ -7246,6 +7255,7 @@ void wpa_supplicant_deinit(struct wpa_global *global)
 	eap_peer_unregister_methods();
 #ifdef CONFIG_AP
 	eap_server_unregister_methods();
+	hostapd_config_flush_sae_pt_cache();
 #endif /* CONFIG_AP */
 
 	for (i = 0; wpa_drivers[i] && global->drv_priv; i++) {
@@ -7282,6 +7292,7 @@ void wpa_supplicant_deinit(struct wpa_global *global)
 	wpa_debug_close_syslog();
 	wpa_debug_close_file();
 	wpa_debug_close_linux_tracing();
+	wpa_debug_close_ring();
 }
 
 
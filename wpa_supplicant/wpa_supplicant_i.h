@@ -208,6 +208,11 @@ struct wpa_params {
 	 */
 	int wpa_debug_tracing;
 
+	/**
+	 * wpa_debug_ring_path - Path of binary trace ring file or %NULL
+	 */
+	const char *wpa_debug_ring_path;
+
 	/**
 	 * override_driver - Optional driver parameter override
 	 *
@@ -280,6 +285,7 @@ struct wpa_global {
 	struct wpa_supplicant *ifaces;
 	struct wpa_params params;
 	struct ctrl_iface_global_priv *ctrl_iface;
+	struct ctrl_iface_cmd_stats *ctrl_stats;
 	struct wpas_dbus_priv *dbus;
 	struct wpas_binder_priv *binder;
 	void **drv_priv;
@@ -621,6 +627,13 @@ struct wpa_supplicant {
 				 struct wpa_scan_results *scan_res);
 	struct dl_list bss; /* struct wpa_bss::list */
 	struct dl_list bss_id; /* struct wpa_bss::list_id */
+#define WPA_BSS_HASH_SIZE 256
+#define WPA_BSS_HASH(bssid) ((bssid)[5])
+#define WPA_BSS_ID_HASH(id) ((id) & (WPA_BSS_HASH_SIZE - 1))
+	/* struct wpa_bss::hnext chains, most recently updated entry first */
+	struct wpa_bss *bss_hash[WPA_BSS_HASH_SIZE];
+	/* struct wpa_bss::hnext_id chains */
+	struct wpa_bss *bss_id_hash[WPA_BSS_HASH_SIZE];
 	size_t num_bss;
 	unsigned int bss_update_idx;
 	unsigned int bss_next_id;
@@ -634,6 +647,13 @@ struct wpa_supplicant {
 	size_t last_scan_res_size;
 	struct os_reltime last_scan;
 
+	/*
+	 * Open addressing hash table of the configured networks keyed by SSID.
+	 * This is only valid during wpa_supplicant_pick_network().
+	 */
+	struct wpa_ssid **ssid_index;
+	size_t ssid_index_size;
+
 	const struct wpa_driver_ops *driver;
 	int interface_removed; /* whether the network interface has been
 				* removed */
@@ -10,7 +10,10 @@
 
 #include "utils/common.h"
 #include "utils/module_tests.h"
+#include "drivers/driver.h"
 #include "wpa_supplicant_i.h"
+#include "config.h"
+#include "bss.h"
 #include "blacklist.h"
 
 
@@ -87,6 +90,120 @@ fail:
 }
 
 
+static void bss_table_bench_res(struct wpa_scan_res *res, unsigned int i)
+{
+	u8 *pos = (u8 *) (res + 1);
+
+	res->bssid[0] = 0x02;
+	WPA_PUT_BE16(&res->bssid[3], i);
+	res->bssid[5] = i;
+	res->freq = 2412 + 5 * (i % 13);
+	res->level = -40 - (int) (i % 50);
+	pos[0] = WLAN_EID_SSID;
+	pos[1] = os_snprintf((char *) pos + 2, SSID_MAX_LEN, "bench-%u",
+			     i % 100);
+	res->ie_len = 2 + pos[1];
+}
+
+
+static int bss_table_bench_scan(struct wpa_supplicant *wpa_s,
+				struct wpa_scan_res *res, unsigned int first,
+				unsigned int num, struct os_reltime *age)
+{
+	struct os_reltime start, now;
+	unsigned int i;
+
+	os_get_reltime(&start);
+	wpa_bss_update_start(wpa_s);
+	for (i = first; i < first + num; i++) {
+		bss_table_bench_res(res, i);
+		wpa_bss_update_scan_res(wpa_s, res, &start);
+	}
+	wpa_bss_update_end(wpa_s, NULL, 1);
+	os_get_reltime(&now);
+	os_reltime_sub(&now, &start, age);
+
+	if (wpa_s->last_scan_res_used != num)
+		return -1;
+	for (i = first; i < first + num; i++) {
+		struct wpa_bss *bss;
+		u8 *pos = (u8 *) (res + 1);
+
+		bss_table_bench_res(res, i);
+		bss = wpa_bss_get(wpa_s, res->bssid, pos + 2, pos[1]);
+		if (!bss || bss != wpa_bss_get_bssid(wpa_s, res->bssid) ||
+		    bss != wpa_bss_get_id(wpa_s, bss->id))
+			return -1;
+	}
+
+	return 0;
+}
+
+
+/* Feed synthetic scans of 1000 BSSes through the BSS table */
+static int wpas_bss_table_benchmark(void)
+{
+	struct wpa_global global;
+	struct wpa_radio radio;
+	struct wpa_supplicant *wpa_s;
+	struct wpa_scan_res *res;
+	struct os_reltime add, update, expire;
+	const unsigned int num = 1000;
+	int ret = -1;
+
+	wpa_s = os_zalloc(sizeof(*wpa_s));
+	res = os_zalloc(sizeof(*res) + 2 + SSID_MAX_LEN);
+	if (!wpa_s || !res)
+		goto fail;
+	os_memset(&global, 0, sizeof(global));
+	os_memset(&radio, 0, sizeof(radio));
+	dl_list_init(&radio.work);
+	wpa_s->global = &global;
+	wpa_s->radio = &radio;
+	wpa_s->conf = wpa_config_alloc_empty(NULL, NULL);
+	if (!wpa_s->conf)
+		goto fail;
+	wpa_s->conf->bss_max_count = 2 * num;
+	wpa_s->conf->bss_expiration_scan_count = 1;
+	wpa_bss_init(wpa_s);
+
+	if (bss_table_bench_scan(wpa_s, res, 0, num, &add) < 0 ||
+	    wpa_s->num_bss != num ||
+	    bss_table_bench_scan(wpa_s, res, 0, num, &update) < 0 ||
+	    wpa_s->num_bss != num ||
+	    bss_table_bench_scan(wpa_s, res, num / 2, num, &expire) < 0 ||
+	    wpa_s->num_bss != num)
+		goto fail;
+
+	bss_table_bench_res(res, 0);
+	if (wpa_bss_get_bssid(wpa_s, res->bssid) ||
+	    wpa_bss_get_id(wpa_s, 0))
+		goto fail;
+
+	wpa_printf(MSG_INFO,
+		   "BSS table benchmark: %u BSSes added in %u.%06u s, updated in %u.%06u s, half replaced in %u.%06u s",
+		   num, (unsigned int) add.sec, (unsigned int) add.usec,
+		   (unsigned int) update.sec, (unsigned int) update.usec,
+		   (unsigned int) expire.sec, (unsigned int) expire.usec);
+
+	ret = 0;
+fail:
+	if (wpa_s && wpa_s->conf) {
+		wpa_bss_deinit(wpa_s);
+		wpa_config_free(wpa_s->conf);
+	}
+	if (wpa_s)
+		os_free(wpa_s->last_scan_res);
+	os_free(wpa_s);
+	os_free(res);
+
+	if (ret)
+		wpa_printf(MSG_ERROR, "BSS table benchmark failure");
+
+	return ret;
+}
+
+
 int wpas_module_tests(void)
 {
 	int ret = 0;
@@ -96,6 +213,9 @@ int wpas_module_tests(void)
 	if (wpas_blacklist_module_tests() < 0)
 		ret = -1;
 
+	if (wpas_bss_table_benchmark() < 0)
+		ret = -1;
+
 #ifdef CONFIG_WPS
 	if (wps_module_tests() < 0)
 		ret = -1;
@@ -0,0 +1,67 @@
+#!/usr/bin/python
+#
+# Control interface command replay benchmark
+#
+# This software may be distributed under the terms of the BSD license.
+# See README for more details.
+
+import sys
+import time
+import wpaspy
+
+def usage():
+    print("usage: replay.py <ctrl_iface path> <workload file> [rounds]")
+    print("")
+    print("The workload file contains one control interface command per")
+    print("line. Empty lines and lines starting with '#' are ignored.")
+    sys.exit(1)
+
+def load_workload(fname):
+    cmds = []
+    with open(fname, 'r') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if not line or line.startswith('#'):
+                continue
+            cmds.append(line)
+    return cmds
+
+def main():
+    if len(sys.argv) < 3:
+        usage()
+    rounds = int(sys.argv[3]) if len(sys.argv) > 3 else 100
+    cmds = load_workload(sys.argv[2])
+    if not cmds:
+        print("Empty workload")
+        sys.exit(1)
+
+    ctrl = wpaspy.Ctrl(sys.argv[1])
+    ctrl.request("CTRL_STATS reset")
+
+    stats = {}
+    start = time.time()
+    for i in range(rounds):
+        for cmd in cmds:
+            t = time.time()
+            ctrl.request(cmd)
+            diff = time.time() - t
+            name = cmd.split(' ')[0]
+            count, total, maxval = stats.get(name, (0, 0.0, 0.0))
+            stats[name] = (count + 1, total + diff, max(maxval, diff))
+    elapsed = time.time() - start
+
+    total_cmds = rounds * len(cmds)
+    print("%d commands in %.3f s (%.1f usec/command)" %
+          (total_cmds, elapsed, 1000000.0 * elapsed / total_cmds))
+    print("")
+    print("Client round trip time:")
+    for name in sorted(stats):
+        count, total, maxval = stats[name]
+        print("%s count=%d avg_usec=%d max_usec=%d" %
+              (name, count, 1000000 * total / count, 1000000 * maxval))
+    print("")
+    print("Server processing time:")
+    print(ctrl.request("CTRL_STATS"))
+
+if __name__ == "__main__":
+    main()